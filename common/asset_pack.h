@@ -0,0 +1,193 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sprite_codec.h"
+
+// sprite frames kept on the sd card instead of in the app binary. the pack
+// is what tools/sprite_compiler.py --pack writes: a header, an index of
+// assets (runs of frames) and frames, then every frame compressed on its
+// own. opening a pack only reads the index; a frame is read and decoded the
+// first time it's asked for, into a small lru cache of ASSET_CACHE_SLOTS
+// frames.
+//
+// not thread safe: a lookup can evict and refill a slot. use a pack from
+// one thread only, for the games that's the game loop, which copies the
+// frames it needs into the state for drawing (see SpriteView in ecs.h).
+
+#define ASSET_PACK_MAGIC "WGPK"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_HEADER_SIZE 12
+#define ASSET_PACK_ASSET_SIZE 16
+#define ASSET_PACK_FRAME_SIZE 8
+#define ASSET_PACK_NAME_LEN 12
+
+#define ASSET_PACK_MAX_ASSETS 16
+#define ASSET_PACK_MAX_FRAMES 64
+// 32x32 at most
+#define ASSET_PACK_MAX_FRAME_BYTES 128
+// compressed frames a bit bigger than raw ones still fit
+#define ASSET_PACK_MAX_PACKED_BYTES (ASSET_PACK_MAX_FRAME_BYTES * 2)
+
+#ifndef ASSET_CACHE_SLOTS
+#define ASSET_CACHE_SLOTS 8
+#endif
+
+#define ASSET_NO_FRAME 0xFFFF
+
+typedef struct {
+    uint16_t first_frame;
+    uint16_t frames;
+} AssetPackAsset;
+
+typedef struct {
+    uint32_t offset; // from the start of the file
+    uint16_t length;
+    uint8_t codec; // SPRITE_CODEC_*
+} AssetPackFrame;
+
+typedef struct {
+    // which frame this slot holds, ASSET_NO_FRAME while free
+    uint16_t frame;
+    // value of the pack's clock when last looked up, oldest goes first
+    uint32_t used;
+    uint8_t data[ASSET_PACK_MAX_FRAME_BYTES];
+} AssetCacheSlot;
+
+typedef struct {
+    Storage* storage;
+    // NULL when there's no usable pack, every lookup then misses
+    File* file;
+    uint8_t frame_w, frame_h;
+    uint16_t frame_bytes;
+    uint16_t asset_count, frame_count;
+    AssetPackAsset assets[ASSET_PACK_MAX_ASSETS];
+    AssetPackFrame frames[ASSET_PACK_MAX_FRAMES];
+    AssetCacheSlot slots[ASSET_CACHE_SLOTS];
+    uint32_t clock;
+    // lookups served from the cache, and ones that read and decoded
+    uint32_t hits, misses;
+} AssetPack;
+
+static inline uint16_t asset_pack_u16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t asset_pack_u32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// header and index, checked against the frame size the caller expects
+static bool asset_pack_read_index(AssetPack* const pack, uint8_t frame_w, uint8_t frame_h) {
+    uint8_t header[ASSET_PACK_HEADER_SIZE];
+    if(storage_file_read(pack->file, header, sizeof(header)) != sizeof(header)) return false;
+    if(memcmp(header, ASSET_PACK_MAGIC, 4) || header[4] != ASSET_PACK_VERSION) return false;
+    if(header[5] != frame_w || header[6] != frame_h) return false;
+    pack->asset_count = asset_pack_u16(&header[8]);
+    pack->frame_count = asset_pack_u16(&header[10]);
+    if(pack->asset_count > ASSET_PACK_MAX_ASSETS || pack->frame_count > ASSET_PACK_MAX_FRAMES) return false;
+
+    for(uint16_t i = 0; i < pack->asset_count; i++) {
+        uint8_t entry[ASSET_PACK_ASSET_SIZE];
+        if(storage_file_read(pack->file, entry, sizeof(entry)) != sizeof(entry)) return false;
+        // the name is only there for tools, assets are looked up by index
+        AssetPackAsset* asset = &pack->assets[i];
+        asset->first_frame = asset_pack_u16(&entry[ASSET_PACK_NAME_LEN]);
+        asset->frames = asset_pack_u16(&entry[ASSET_PACK_NAME_LEN + 2]);
+        if(asset->first_frame + asset->frames > pack->frame_count) return false;
+    }
+    for(uint16_t i = 0; i < pack->frame_count; i++) {
+        uint8_t entry[ASSET_PACK_FRAME_SIZE];
+        if(storage_file_read(pack->file, entry, sizeof(entry)) != sizeof(entry)) return false;
+        AssetPackFrame* frame = &pack->frames[i];
+        frame->offset = asset_pack_u32(&entry[0]);
+        frame->length = asset_pack_u16(&entry[4]);
+        frame->codec = entry[6];
+        if(frame->length > ASSET_PACK_MAX_PACKED_BYTES) return false;
+    }
+    return true;
+}
+
+// open the pack at path for frames of frame_w x frame_h. a missing or
+// broken pack isn't fatal, every frame lookup just comes back NULL
+static AssetPack* asset_pack_alloc(const char* path, uint8_t frame_w, uint8_t frame_h) {
+    AssetPack* pack = malloc(sizeof(AssetPack));
+    memset(pack, 0, sizeof(AssetPack));
+    pack->frame_w = frame_w;
+    pack->frame_h = frame_h;
+    pack->frame_bytes = (frame_w + 7) / 8 * frame_h;
+    for(uint8_t i = 0; i < ASSET_CACHE_SLOTS; i++) {
+        pack->slots[i].frame = ASSET_NO_FRAME;
+    }
+    pack->storage = furi_record_open(RECORD_STORAGE);
+    pack->file = storage_file_alloc(pack->storage);
+    if(pack->frame_bytes > ASSET_PACK_MAX_FRAME_BYTES ||
+       !storage_file_open(pack->file, path, FSAM_READ, FSOM_OPEN_EXISTING) ||
+       !asset_pack_read_index(pack, frame_w, frame_h)) {
+        FURI_LOG_W("AssetPack", "no usable pack at %s", path);
+        storage_file_free(pack->file);
+        pack->file = NULL;
+        pack->asset_count = 0;
+        pack->frame_count = 0;
+    }
+    return pack;
+}
+
+static void asset_pack_free(AssetPack* const pack) {
+    if(pack->file) {
+        storage_file_close(pack->file);
+        storage_file_free(pack->file);
+    }
+    furi_record_close(RECORD_STORAGE);
+    free(pack);
+}
+
+// read and decode frame into slot. false leaves the slot free
+static bool asset_pack_load(AssetPack* const pack, AssetCacheSlot* const slot, uint16_t frame) {
+    const AssetPackFrame* entry = &pack->frames[frame];
+    uint8_t packed[ASSET_PACK_MAX_PACKED_BYTES];
+    slot->frame = ASSET_NO_FRAME;
+    if(!storage_file_seek(pack->file, entry->offset, true) ||
+       storage_file_read(pack->file, packed, entry->length) != entry->length) {
+        FURI_LOG_E("AssetPack", "frame %u: short read", frame);
+        return false;
+    }
+    if(!sprite_decode(entry->codec, packed, entry->length, slot->data, pack->frame_bytes)) {
+        FURI_LOG_E("AssetPack", "frame %u: bad data", frame);
+        return false;
+    }
+    slot->frame = frame;
+    return true;
+}
+
+// packed 1bpp frame 'frame' of asset 'asset', or NULL if the pack doesn't
+// have it. only good until the next lookup, which may reuse the slot
+static const uint8_t* asset_pack_frame(AssetPack* const pack, uint16_t asset, uint16_t frame) {
+    if(asset >= pack->asset_count || frame >= pack->assets[asset].frames) return NULL;
+    uint16_t index = pack->assets[asset].first_frame + frame;
+    pack->clock++;
+
+    AssetCacheSlot* victim = &pack->slots[0];
+    for(uint8_t i = 0; i < ASSET_CACHE_SLOTS; i++) {
+        AssetCacheSlot* slot = &pack->slots[i];
+        if(slot->frame == index) {
+            slot->used = pack->clock;
+            pack->hits++;
+            return slot->data;
+        }
+        // free slots first, then the least recently used
+        if(victim->frame != ASSET_NO_FRAME && (slot->frame == ASSET_NO_FRAME || slot->used < victim->used)) {
+            victim = slot;
+        }
+    }
+    pack->misses++;
+    if(!asset_pack_load(pack, victim, index)) return NULL;
+    victim->used = pack->clock;
+    return victim->data;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <furi.h>
+
+#include <stdint.h>
+
+// fixed timestep accumulator. the frame timer can fire at whatever rate the
+// display keeps up with, game logic still runs at exactly logic_hz, and the
+// leftover fraction of a step is handed to drawing for interpolation.
+
+// how many logic steps one frame may catch up on before we drop time
+#define FIXED_STEP_MAX_CATCHUP 4
+
+typedef struct {
+    uint32_t step_ticks; // kernel ticks per logic step
+    uint32_t last_tick;
+    uint32_t accumulator;
+    uint32_t dropped; // logic steps skipped because a frame came too late
+} FixedStep;
+
+static inline void fixed_step_init(FixedStep* const fixed_step, uint32_t logic_hz) {
+    fixed_step->step_ticks = furi_kernel_get_tick_frequency() / logic_hz;
+    if(!fixed_step->step_ticks) fixed_step->step_ticks = 1;
+    fixed_step->last_tick = furi_get_tick();
+    fixed_step->accumulator = 0;
+    fixed_step->dropped = 0;
+}
+
+// pick up again after the frame timer was stopped, without treating the
+// time spent stopped as steps we owe
+static inline void fixed_step_resume(FixedStep* const fixed_step) {
+    fixed_step->last_tick = furi_get_tick();
+}
+
+// call once per frame, returns how many logic steps to run now
+static inline uint8_t fixed_step_advance(FixedStep* const fixed_step) {
+    uint32_t now = furi_get_tick();
+    fixed_step->accumulator += now - fixed_step->last_tick;
+    fixed_step->last_tick = now;
+
+    uint32_t steps = fixed_step->accumulator / fixed_step->step_ticks;
+    fixed_step->accumulator -= steps * fixed_step->step_ticks;
+    if(steps > FIXED_STEP_MAX_CATCHUP) {
+        // we fell way behind (debugger, long redraw). don't try to make it
+        // all up in one frame, that only makes the next frame late too.
+        fixed_step->dropped += steps - FIXED_STEP_MAX_CATCHUP;
+        steps = FIXED_STEP_MAX_CATCHUP;
+    }
+    return steps;
+}
+
+// how far we are between the last step and the next, 0..255
+static inline uint8_t fixed_step_alpha(const FixedStep* const fixed_step) {
+    return (fixed_step->accumulator * 256) / fixed_step->step_ticks;
+}
+
+// a + (b - a) * alpha / 256
+static inline int32_t fixed_step_lerp(int32_t a, int32_t b, uint8_t alpha) {
+    return a + (((b - a) * alpha) >> 8);
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <furi.h>
+#include <gui/gui.h>
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// per stage timing of the game loop. each stage keeps min/sum/max over a
+// window of PROFILER_WINDOW samples; when a window fills, its min/avg/max
+// are published and the next window starts. one thread
+// records each stage, published numbers are atomics so the overlay on the
+// gui thread can read them any time.
+//
+// times come from the cycle counter on the device (DWT, 64 per us) and
+// clock_gettime on the host build, so host numbers are real cpu time even
+// though the simulator's clock is virtual. the device reports microseconds,
+// the host nanoseconds since everything there takes well under one.
+
+#ifdef FURI_HOST
+#include <time.h>
+#define PROFILER_TICKS_PER_UNIT 1
+#define PROFILER_UNIT "ns"
+static inline uint32_t profiler_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    // wraps every few seconds, only ever used for differences
+    return (uint32_t)ts.tv_sec * 1000000000u + (uint32_t)ts.tv_nsec;
+}
+#else
+#include <furi_hal.h>
+#define PROFILER_TICKS_PER_UNIT (SystemCoreClock / 1000000)
+#define PROFILER_UNIT "us"
+// the firmware has the cycle counter running from boot
+static inline uint32_t profiler_now(void) {
+    return DWT->CYCCNT;
+}
+#endif
+
+#define PROFILER_WINDOW 64
+
+typedef enum {
+    ProfileStageInput, // polling keys and the game's handling of them
+    ProfileStageLogic, // the logic steps of one frame
+    ProfileStageSnapshot, // comparing and publishing the state
+    ProfileStageDraw, // the draw hook, gui thread
+    ProfileStageCount,
+} ProfileStage;
+
+typedef struct {
+    // the window being filled, only its stage's thread touches it
+    uint32_t min, max, sum;
+    uint16_t count;
+    // the latest sample, ticks
+    uint32_t last;
+    // the last full window, in PROFILER_UNIT
+    atomic_uint_least32_t shown_min, shown_avg, shown_max;
+} ProfileStageStats;
+
+typedef struct {
+    ProfileStageStats stages[ProfileStageCount];
+    // logic steps fixed_step gave up on, and frames that ran late enough
+    // to need more than one step
+    atomic_uint_least32_t dropped_steps;
+    atomic_uint_least32_t late_frames;
+} FrameProfiler;
+
+static const char* const profile_stage_names[ProfileStageCount] = {
+    [ProfileStageInput] = "input",
+    [ProfileStageLogic] = "logic",
+    [ProfileStageSnapshot] = "snap",
+    [ProfileStageDraw] = "draw",
+};
+
+static inline void profiler_init(FrameProfiler* const profiler) {
+    for(uint8_t i = 0; i < ProfileStageCount; i++) {
+        ProfileStageStats* stats = &profiler->stages[i];
+        stats->min = UINT32_MAX;
+        stats->max = stats->sum = stats->count = stats->last = 0;
+        atomic_init(&stats->shown_min, 0);
+        atomic_init(&stats->shown_avg, 0);
+        atomic_init(&stats->shown_max, 0);
+    }
+    atomic_init(&profiler->dropped_steps, 0);
+    atomic_init(&profiler->late_frames, 0);
+}
+
+// one sample of 'ticks' for a stage. returns true when it completed a window
+static bool profiler_record(FrameProfiler* const profiler, ProfileStage stage, uint32_t ticks) {
+    ProfileStageStats* stats = &profiler->stages[stage];
+    stats->last = ticks;
+    if(ticks < stats->min) stats->min = ticks;
+    if(ticks > stats->max) stats->max = ticks;
+    stats->sum += ticks;
+    if(++stats->count < PROFILER_WINDOW) return false;
+
+    atomic_store_explicit(&stats->shown_min, stats->min / PROFILER_TICKS_PER_UNIT, memory_order_relaxed);
+    atomic_store_explicit(&stats->shown_avg, stats->sum / PROFILER_WINDOW / PROFILER_TICKS_PER_UNIT, memory_order_relaxed);
+    atomic_store_explicit(&stats->shown_max, stats->max / PROFILER_TICKS_PER_UNIT, memory_order_relaxed);
+    stats->min = UINT32_MAX;
+    stats->max = stats->sum = stats->count = 0;
+    return true;
+}
+
+// time since 'start' (a profiler_now()) as one sample
+static inline bool profiler_stop(FrameProfiler* const profiler, ProfileStage stage, uint32_t start) {
+    return profiler_record(profiler, stage, profiler_now() - start);
+}
+
+static void profiler_log(const FrameProfiler* const profiler, const char* tag) {
+    for(uint8_t i = 0; i < ProfileStageCount; i++) {
+        const ProfileStageStats* stats = &profiler->stages[i];
+        FURI_LOG_I(
+            tag,
+            "%-5s min %lu avg %lu max %lu " PROFILER_UNIT,
+            profile_stage_names[i],
+            (unsigned long)atomic_load_explicit(&stats->shown_min, memory_order_relaxed),
+            (unsigned long)atomic_load_explicit(&stats->shown_avg, memory_order_relaxed),
+            (unsigned long)atomic_load_explicit(&stats->shown_max, memory_order_relaxed));
+    }
+    FURI_LOG_I(
+        tag,
+        "dropped steps %lu, late frames %lu",
+        (unsigned long)atomic_load_explicit(&profiler->dropped_steps, memory_order_relaxed),
+        (unsigned long)atomic_load_explicit(&profiler->late_frames, memory_order_relaxed));
+}
+
+// the numbers (min/avg/max) in small print down the left edge, over
+// whatever the game drew
+static void profiler_draw(const FrameProfiler* const profiler, Canvas* const canvas) {
+    char lines[ProfileStageCount + 1][40];
+    for(uint8_t i = 0; i < ProfileStageCount; i++) {
+        const ProfileStageStats* stats = &profiler->stages[i];
+        snprintf(
+            lines[i],
+            sizeof(lines[i]),
+            "%s %lu/%lu/%lu",
+            profile_stage_names[i],
+            (unsigned long)atomic_load_explicit(&stats->shown_min, memory_order_relaxed),
+            (unsigned long)atomic_load_explicit(&stats->shown_avg, memory_order_relaxed),
+            (unsigned long)atomic_load_explicit(&stats->shown_max, memory_order_relaxed));
+    }
+    snprintf(
+        lines[ProfileStageCount],
+        sizeof(lines[ProfileStageCount]),
+        "drop %lu late %lu",
+        (unsigned long)atomic_load_explicit(&profiler->dropped_steps, memory_order_relaxed),
+        (unsigned long)atomic_load_explicit(&profiler->late_frames, memory_order_relaxed));
+
+    canvas_set_font(canvas, FontKeyboard);
+    const uint8_t line_h = 8;
+    const uint8_t count = ProfileStageCount + 1;
+    const uint8_t top = canvas_height(canvas) - count * line_h;
+    uint16_t width = 0;
+    for(uint8_t i = 0; i < count; i++) {
+        uint16_t w = canvas_string_width(canvas, lines[i]);
+        if(w > width) width = w;
+    }
+    // clear a box behind the text so it reads over anything
+    canvas_set_color(canvas, ColorWhite);
+    canvas_draw_box(canvas, 0, top, width + 2, count * line_h);
+    canvas_set_color(canvas, ColorBlack);
+    for(uint8_t i = 0; i < count; i++) {
+        canvas_draw_str(canvas, 1, top + (i + 1) * line_h - 1, lines[i]);
+    }
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "input_state.h"
+
+// a recording of one session: the seed game_random.h started from, then one
+// record per pass of the game loop holding everything the update hook got
+// from outside the game (keys, tick, logic steps, alpha). handing the same
+// build the same records in order makes it do exactly what it did live.
+//
+// header, 16 bytes: "GJNL", version, 3 reserved, state size and seed (u32
+// little endian). the state size is there to catch a journal from a build
+// whose state looks different.
+// record: a flags byte, bit 0 tick, bits 1-3 logic steps, bit 4 keys
+// changed. a tick is followed by alpha, changed keys by held, pressed and
+// released, one byte each. held only gets written when something about the
+// keys changed, so a plain frame tick costs 2 bytes, about 7 KB a minute.
+//
+// writes go through a small buffer, the sd card only sees whole blocks.
+
+#define GAME_JOURNAL_MAGIC "GJNL"
+#define GAME_JOURNAL_VERSION 1
+#define GAME_JOURNAL_HEADER_SIZE 16
+#define GAME_JOURNAL_BUFFER 512
+
+#define GAME_JOURNAL_TICK 0x01
+#define GAME_JOURNAL_STEPS_SHIFT 1
+#define GAME_JOURNAL_STEPS_MAX 7
+#define GAME_JOURNAL_KEYS 0x10
+
+// what a record holds
+typedef struct {
+    InputFrame input;
+    bool tick;
+    uint8_t steps;
+    uint8_t alpha;
+} GameJournalPass;
+
+typedef struct {
+    Storage* storage;
+    File* file;
+    bool writing;
+    uint32_t seed;
+    // records written or read so far
+    uint32_t passes;
+    // held keys as of the last record
+    uint32_t held;
+    uint8_t buffer[GAME_JOURNAL_BUFFER];
+    // bytes in the buffer, and the read cursor into them
+    uint16_t fill, pos;
+} GameJournal;
+
+static inline void game_journal_put_u32(uint8_t* p, uint32_t value) {
+    p[0] = value;
+    p[1] = value >> 8;
+    p[2] = value >> 16;
+    p[3] = value >> 24;
+}
+
+static inline uint32_t game_journal_get_u32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static GameJournal* game_journal_alloc(bool writing) {
+    GameJournal* journal = malloc(sizeof(GameJournal));
+    memset(journal, 0, sizeof(GameJournal));
+    journal->writing = writing;
+    journal->storage = furi_record_open(RECORD_STORAGE);
+    journal->file = storage_file_alloc(journal->storage);
+    return journal;
+}
+
+static void game_journal_flush(GameJournal* const journal) {
+    if(journal->fill && storage_file_write(journal->file, journal->buffer, journal->fill) != journal->fill) {
+        FURI_LOG_E("Journal", "short write, the journal is cut off");
+    }
+    journal->fill = 0;
+}
+
+static void game_journal_free(GameJournal* const journal) {
+    if(journal->writing) {
+        game_journal_flush(journal);
+    }
+    storage_file_close(journal->file);
+    storage_file_free(journal->file);
+    furi_record_close(RECORD_STORAGE);
+    free(journal);
+}
+
+// every directory on the way to path, like mkdir -p
+static void game_journal_mkdirs(Storage* const storage, const char* path) {
+    char dir[128];
+    strncpy(dir, path, sizeof(dir) - 1);
+    dir[sizeof(dir) - 1] = '\0';
+    for(char* slash = strchr(dir + 1, '/'); slash; slash = strchr(slash + 1, '/')) {
+        *slash = '\0';
+        storage_simply_mkdir(storage, dir);
+        *slash = '/';
+    }
+}
+
+// start a new journal at path, replacing any old one. NULL if it can't be
+// created
+static GameJournal* game_journal_record(const char* path, uint32_t state_size, uint32_t seed) {
+    GameJournal* journal = game_journal_alloc(true);
+    journal->seed = seed;
+    game_journal_mkdirs(journal->storage, path);
+    if(!storage_file_open(journal->file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        FURI_LOG_E("Journal", "can't create %s", path);
+        game_journal_free(journal);
+        return NULL;
+    }
+    uint8_t* header = journal->buffer;
+    memset(header, 0, GAME_JOURNAL_HEADER_SIZE);
+    memcpy(header, GAME_JOURNAL_MAGIC, 4);
+    header[4] = GAME_JOURNAL_VERSION;
+    game_journal_put_u32(&header[8], state_size);
+    game_journal_put_u32(&header[12], seed);
+    journal->fill = GAME_JOURNAL_HEADER_SIZE;
+    return journal;
+}
+
+static void game_journal_write(GameJournal* const journal, const GameJournalPass* const pass) {
+    // the longest record
+    if(journal->fill + 5 > GAME_JOURNAL_BUFFER) {
+        game_journal_flush(journal);
+    }
+    const InputFrame* input = &pass->input;
+    bool keys = input->held != journal->held || input->pressed || input->released;
+    uint8_t steps = pass->steps > GAME_JOURNAL_STEPS_MAX ? GAME_JOURNAL_STEPS_MAX : pass->steps;
+    uint8_t* out = &journal->buffer[journal->fill];
+    *out++ = (pass->tick ? GAME_JOURNAL_TICK : 0) | (steps << GAME_JOURNAL_STEPS_SHIFT) |
+             (keys ? GAME_JOURNAL_KEYS : 0);
+    if(pass->tick) {
+        *out++ = pass->alpha;
+    }
+    if(keys) {
+        *out++ = input->held;
+        *out++ = input->pressed;
+        *out++ = input->released;
+        journal->held = input->held;
+    }
+    journal->fill = out - journal->buffer;
+    journal->passes++;
+}
+
+// open a journal for replay, its seed ends up in journal->seed. NULL if
+// there's none or it's from a build with a different state
+static GameJournal* game_journal_replay(const char* path, uint32_t state_size) {
+    GameJournal* journal = game_journal_alloc(false);
+    uint8_t header[GAME_JOURNAL_HEADER_SIZE];
+    if(!storage_file_open(journal->file, path, FSAM_READ, FSOM_OPEN_EXISTING) ||
+       storage_file_read(journal->file, header, sizeof(header)) != sizeof(header) ||
+       memcmp(header, GAME_JOURNAL_MAGIC, 4) || header[4] != GAME_JOURNAL_VERSION) {
+        FURI_LOG_E("Journal", "no journal at %s", path);
+        game_journal_free(journal);
+        return NULL;
+    }
+    if(game_journal_get_u32(&header[8]) != state_size) {
+        FURI_LOG_E("Journal", "%s is from another build", path);
+        game_journal_free(journal);
+        return NULL;
+    }
+    journal->seed = game_journal_get_u32(&header[12]);
+    return journal;
+}
+
+// next byte of the file, false at its end
+static bool game_journal_byte(GameJournal* const journal, uint8_t* const byte) {
+    if(journal->pos == journal->fill) {
+        journal->fill = storage_file_read(journal->file, journal->buffer, GAME_JOURNAL_BUFFER);
+        journal->pos = 0;
+        if(!journal->fill) return false;
+    }
+    *byte = journal->buffer[journal->pos++];
+    return true;
+}
+
+// the next record, false once there are no more (or the last is cut off)
+static bool game_journal_read(GameJournal* const journal, GameJournalPass* const pass) {
+    uint8_t flags, byte;
+    if(!game_journal_byte(journal, &flags)) return false;
+    pass->tick = flags & GAME_JOURNAL_TICK;
+    pass->steps = (flags >> GAME_JOURNAL_STEPS_SHIFT) & GAME_JOURNAL_STEPS_MAX;
+    pass->alpha = 0;
+    if(pass->tick) {
+        if(!game_journal_byte(journal, &pass->alpha)) return false;
+    }
+    pass->input = (InputFrame){.held = journal->held};
+    if(flags & GAME_JOURNAL_KEYS) {
+        if(!game_journal_byte(journal, &byte)) return false;
+        pass->input.held = journal->held = byte;
+        if(!game_journal_byte(journal, &byte)) return false;
+        pass->input.pressed = byte;
+        if(!game_journal_byte(journal, &byte)) return false;
+        pass->input.released = byte;
+    }
+    journal->passes++;
+    return true;
+}
+
+// back to the first record, to replay it all again
+static bool game_journal_rewind(GameJournal* const journal) {
+    journal->fill = journal->pos = 0;
+    journal->held = 0;
+    journal->passes = 0;
+    return storage_file_seek(journal->file, GAME_JOURNAL_HEADER_SIZE, true);
+}
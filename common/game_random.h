@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+
+// the games' dice. a xorshift32 the runtime seeds once before init, so a
+// whole session follows from one number and a journal (game_journal.h)
+// only has to store that. games roll with this, never furi_hal_random_get.
+//
+// one generator per app, only the game loop thread rolls.
+
+static uint32_t game_random_state = 0x9E3779B9u;
+
+static inline void game_random_seed(uint32_t seed) {
+    // xorshift never leaves 0
+    game_random_state = seed ? seed : 0x9E3779B9u;
+}
+
+static inline uint32_t game_random_get(void) {
+    uint32_t x = game_random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    game_random_state = x;
+    return x;
+}
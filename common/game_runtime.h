@@ -0,0 +1,425 @@
+#pragma once
+
+#include <furi.h>
+#include <furi_hal_random.h>
+#include <gui/gui.h>
+#include <input/input.h>
+#include <notification/notification.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "fixed_step.h"
+#include "frame_profiler.h"
+#include "game_journal.h"
+#include "game_random.h"
+#include "input_state.h"
+#include "triple_buffer.h"
+
+// the app main loop, shared by every game. a game hands game_run() its state
+// size, rates and hooks, the runtime owns everything else:
+//  - the event queue, frame timer and fixed timestep (fixed_step.h)
+//  - key state from the input thread (input_state.h)
+//  - handing snapshots to the gui thread (triple_buffer.h), only when the
+//    state actually changed
+//  - stopping the timer while the game says it's idle
+//  - the gui and notification records
+//  - seeding game_random.h, and recording or replaying sessions
+// the state lives on the heap and only the game loop thread touches it, the
+// draw hook only ever sees snapshots.
+//
+// the app's launch args pick the mode:
+//   (none)                    play
+//   record [path]             play, and journal every pass (game_journal.h)
+//   replay [path] [runs]      run a journal instead of the keys, runs times
+//                             over (default once), then exit. back stops it
+// path defaults to the game's journal_path. a replay feeds update exactly
+// the frames it got live, one per pass, so the same build ends up in the
+// same states and draws the same frames.
+
+// build with GAME_PROFILE=1 to time every stage of the loop and log the
+// numbers about once a second, 2 to also draw them over the game. see
+// frame_profiler.h. 0 compiles all of it out.
+#ifndef GAME_PROFILE
+#define GAME_PROFILE 0
+#endif
+
+_Static_assert(FIXED_STEP_MAX_CATCHUP <= GAME_JOURNAL_STEPS_MAX, "a journal record can't hold that many steps");
+
+// 0= frame tick 1= input state changed, see InputState for the keys
+typedef enum {
+    GameEventTick,
+    GameEventKey,
+} GameEventType;
+
+typedef struct {
+    GameEventType type;
+} GameEvent;
+
+// what one pass of the loop hands the update hook
+typedef struct {
+    // the keys, polled once per pass
+    InputFrame input;
+    // true on a frame tick, false when only input woke the loop
+    bool tick;
+    // logic steps due this pass, only ever nonzero on a tick
+    uint8_t steps;
+    // how far into the next logic step this frame is, 0..255
+    uint8_t alpha;
+    NotificationApp* notify;
+    FrameProfiler* profiler;
+} GameFrame;
+
+typedef enum {
+    GameStatusRunning,
+    // nothing can change until a key goes down, the timer may stop
+    GameStatusIdle,
+    GameStatusExit,
+} GameStatus;
+
+typedef struct {
+    const char* name; // log tag
+    size_t state_size;
+    // game logic rate and how often we ask for a redraw. logic runs at
+    // exactly logic_hz no matter how fast frames come
+    uint32_t logic_hz;
+    uint32_t frame_hz;
+    // set up a fresh state
+    void (*init)(void* state);
+    // apply input, run the due logic steps, say whether to keep going
+    GameStatus (*update)(void* state, const GameFrame* frame);
+    // gui thread, draws a snapshot
+    void (*draw)(const void* state, Canvas* canvas);
+    // optional, release whatever init acquired besides the state itself
+    void (*free)(void* state);
+    // where record and replay keep the journal unless told otherwise
+    const char* journal_path;
+} Game;
+
+typedef enum {
+    GameModePlay,
+    GameModeRecord,
+    GameModeReplay,
+} GameMode;
+
+typedef struct {
+    GameMode mode;
+    const char* journal_path;
+    uint32_t runs;
+    char args[128];
+} GameLaunch;
+
+// split the launch args up, see the top of the file. false if they make
+// no sense
+static bool game_launch_parse(const Game* const game, const char* args, GameLaunch* const launch) {
+    launch->mode = GameModePlay;
+    launch->journal_path = game->journal_path;
+    launch->runs = 1;
+    if(!args || !*args) return true;
+    strncpy(launch->args, args, sizeof(launch->args) - 1);
+    launch->args[sizeof(launch->args) - 1] = '\0';
+
+    char* rest = launch->args;
+    const char* mode = strsep(&rest, " ");
+    if(!strcmp(mode, "record")) {
+        launch->mode = GameModeRecord;
+    } else if(!strcmp(mode, "replay")) {
+        launch->mode = GameModeReplay;
+    } else {
+        return false;
+    }
+    for(const char* word; (word = strsep(&rest, " "));) {
+        if(word[0] == '/') {
+            launch->journal_path = word;
+        } else if(launch->mode == GameModeReplay && word[0] >= '1' && word[0] <= '9') {
+            launch->runs = strtoul(word, NULL, 10);
+        } else if(word[0]) {
+            return false;
+        }
+    }
+    return launch->journal_path != NULL;
+}
+
+// games wrap their logic steps in these, so the profiler can tell logic from
+// input handling. free when GAME_PROFILE is 0
+static inline uint32_t game_logic_begin(void) {
+    return GAME_PROFILE ? profiler_now() : 0;
+}
+
+static inline void game_logic_end(const GameFrame* const frame, uint32_t start) {
+    if(GAME_PROFILE) profiler_stop(frame->profiler, ProfileStageLogic, start);
+}
+
+// what the gui thread needs to draw
+typedef struct {
+    const Game* game;
+    TripleBuffer snapshots;
+    FrameProfiler* profiler;
+} GameRender;
+
+// a replay run is over: rewind for the next one, or exit if that was the
+// last. the caller starts the state over with game_restart
+static GameStatus game_replay_end(const Game* const game, GameJournal* const journal, uint32_t* const runs_left) {
+    FURI_LOG_I(game->name, "replayed %lu passes", (unsigned long)journal->passes);
+    if(--*runs_left == 0) return GameStatusExit;
+    game_journal_rewind(journal);
+    return GameStatusRunning;
+}
+
+// start over from a fresh state seeded with seed. free and init let go of
+// and allocate whatever the game keeps pointers to, and the snapshots the
+// gui can still draw hold the old pointers. so take the view port out of
+// the gui first, which waits out a draw in progress like it does at exit,
+// then start every snapshot from the new state and put the view port back
+static void game_restart(
+    const Game* const game,
+    void* state,
+    uint32_t seed,
+    GameRender* const render,
+    void* last_published,
+    Gui* const gui,
+    ViewPort* const view_port) {
+    gui_remove_view_port(gui, view_port);
+    if(game->free) {
+        game->free(state);
+    }
+    game_random_seed(seed);
+    game->init(state);
+    // nothing reads the snapshots while the view port is out
+    triple_buffer_init(&render->snapshots, render->snapshots.slots, game->state_size, state);
+    memcpy(last_published, state, game->state_size);
+    gui_add_view_port(gui, view_port, GuiLayerFullscreen);
+}
+
+// where the input callback records keys, and the queue it wakes
+typedef struct {
+    InputState input_state;
+    FuriMessageQueue* event_queue;
+} GameInput;
+
+static void game_render_callback(Canvas* const canvas, void* ctx) {
+    GameRender* render = ctx;
+    uint32_t start = GAME_PROFILE ? profiler_now() : 0;
+    // newest snapshot the game loop published. lock-free, so a frame is
+    // never skipped and the game loop never waits on drawing
+    render->game->draw(triple_buffer_read(&render->snapshots), canvas);
+    if(GAME_PROFILE) {
+        profiler_stop(render->profiler, ProfileStageDraw, start);
+    }
+    if(GAME_PROFILE >= 2) {
+        profiler_draw(render->profiler, canvas);
+    }
+}
+
+static void game_input_callback(InputEvent* input_event, void* ctx) {
+    GameInput* input = ctx;
+    // DEBUG MODE ONLY: crash program if unable to access message queue
+    furi_assert(input);
+    // record the key. only wake the loop if it isn't already due to wake,
+    // and never wait on the queue, this runs on the input service thread
+    if(input_state_feed(&input->input_state, input_event)) {
+        GameEvent event = {.type = GameEventKey};
+        furi_message_queue_put(input->event_queue, &event, 0);
+    }
+}
+
+static void game_timer_callback(void* ctx) {
+    FuriMessageQueue* event_queue = ctx;
+    furi_assert(event_queue);
+
+    GameEvent event = {.type = GameEventTick};
+    furi_message_queue_put(event_queue, &event, 0);
+}
+
+// run a game until its update hook says exit. args are the app's launch
+// args, NULL to just play
+static int32_t game_run(const Game* const game, const char* args) {
+    GameLaunch launch;
+    if(!game_launch_parse(game, args, &launch)) {
+        FURI_LOG_E(game->name, "bad args '%s', want record|replay [path] [runs]", args);
+        return -1;
+    }
+    // a replay starts from the seed it was recorded with, and can't go
+    // without its journal
+    uint32_t seed = furi_hal_random_get();
+    GameJournal* journal = NULL;
+    uint32_t runs_left = launch.runs;
+    const bool replay = launch.mode == GameModeReplay;
+    if(replay) {
+        journal = game_journal_replay(launch.journal_path, game->state_size);
+        if(!journal) return -1;
+        seed = journal->seed;
+    } else if(launch.mode == GameModeRecord) {
+        // no card is no reason not to play
+        journal = game_journal_record(launch.journal_path, game->state_size, seed);
+    }
+    game_random_seed(seed);
+
+    // build message queue of length 8, for GameEvents
+    FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(GameEvent));
+    // build game state
+    void* state = malloc(game->state_size);
+    game->init(state);
+    // three render snapshots of the state, handed to the gui through a
+    // lock-free triple buffer
+    void* snapshots = malloc(3 * game->state_size);
+    FrameProfiler profiler;
+    profiler_init(&profiler);
+    GameRender render = {.game = game, .profiler = &profiler};
+    triple_buffer_init(&render.snapshots, snapshots, game->state_size, state);
+    // what the gui was last handed, so passes that change nothing don't redraw
+    void* last_published = malloc(game->state_size);
+    memcpy(last_published, state, game->state_size);
+
+    // build the viewport
+    ViewPort* view_port = view_port_alloc();
+    view_port_draw_callback_set(view_port, game_render_callback, &render);
+    GameInput input = {.event_queue = event_queue};
+    input_state_init(&input.input_state);
+    view_port_input_callback_set(view_port, game_input_callback, &input);
+
+    // build the frame timer. logic steps are paced by fixed_step, not by this
+    const uint32_t frame_ticks = furi_kernel_get_tick_frequency() / game->frame_hz;
+    FuriTimer* timer = furi_timer_alloc(game_timer_callback, FuriTimerTypePeriodic, event_queue);
+    furi_timer_start(timer, frame_ticks);
+    bool timer_running = true;
+    FixedStep fixed_step;
+    fixed_step_init(&fixed_step, game->logic_hz);
+
+    // Open GUI and register view_port
+    Gui* gui = furi_record_open(RECORD_GUI);
+    gui_add_view_port(gui, view_port, GuiLayerFullscreen);
+
+    NotificationApp* notification = furi_record_open(RECORD_NOTIFICATION);
+
+    GameEvent event;
+    for(GameStatus status = GameStatusRunning; status != GameStatusExit;) {
+        // check if message waiting. while idle the timer is stopped and only
+        // input can change anything, so sleep until a key wakes us
+        FuriStatus event_status =
+            furi_message_queue_get(event_queue, &event, timer_running ? 100 : FuriWaitForever);
+        uint32_t update_start = GAME_PROFILE ? profiler_now() : 0;
+        GameFrame frame = {
+            // read the keys once per pass
+            .input = input_state_poll(&input.input_state),
+            .tick = event_status == FuriStatusOk && event.type == GameEventTick,
+            .notify = notification,
+            .profiler = &profiler,
+        };
+        if(event_status != FuriStatusOk) {
+            FURI_LOG_D(game->name, "FuriMessageQueue: event timeout");
+        }
+        if(replay) {
+            // the journal says what this pass got, the real keys only get
+            // to stop it
+            GameJournalPass pass;
+            if(frame.input.pressed & INPUT_KEY_BIT(InputKeyBack)) {
+                status = GameStatusExit;
+                continue;
+            }
+            if(!game_journal_read(journal, &pass)) {
+                // a journal that ends without the game quitting
+                status = game_replay_end(game, journal, &runs_left);
+                if(status != GameStatusExit) {
+                    game_restart(game, state, journal->seed, &render, last_published, gui, view_port);
+                }
+                continue;
+            }
+            frame.input = pass.input;
+            frame.tick = pass.tick;
+            frame.steps = pass.steps;
+            frame.alpha = pass.alpha;
+        } else if(frame.tick) {
+            // however many logic steps are due, and how far we are into the
+            // next one for drawing
+            frame.steps = fixed_step_advance(&fixed_step);
+            frame.alpha = fixed_step_alpha(&fixed_step);
+        }
+        if(journal && !replay) {
+            game_journal_write(
+                journal,
+                &(GameJournalPass){
+                    .input = frame.input, .tick = frame.tick, .steps = frame.steps, .alpha = frame.alpha});
+        }
+        if(GAME_PROFILE && frame.steps > 1) {
+            atomic_fetch_add_explicit(&profiler.late_frames, 1, memory_order_relaxed);
+        }
+        if(GAME_PROFILE) {
+            profiler.stages[ProfileStageLogic].last = 0;
+        }
+        status = game->update(state, &frame);
+        if(replay && status == GameStatusExit) {
+            status = game_replay_end(game, journal, &runs_left);
+            if(status != GameStatusExit) {
+                game_restart(game, state, journal->seed, &render, last_published, gui, view_port);
+            }
+        }
+        if(GAME_PROFILE) {
+            // whatever the update hook spent outside its logic steps
+            uint32_t input_ticks = profiler_now() - update_start - profiler.stages[ProfileStageLogic].last;
+            atomic_store_explicit(&profiler.dropped_steps, fixed_step.dropped, memory_order_relaxed);
+            // about once a second at 60 passes a second
+            if(profiler_record(&profiler, ProfileStageInput, input_ticks)) {
+                profiler_log(&profiler, game->name);
+            }
+        }
+
+        // stop the frame timer while nothing can move, start it again on
+        // the first key that changes that. a replay has no keys to wait on
+        bool idle = status == GameStatusIdle && !replay;
+        if(idle && timer_running) {
+            furi_timer_stop(timer);
+            timer_running = false;
+        } else if(!idle && !timer_running) {
+            fixed_step_resume(&fixed_step);
+            furi_timer_start(timer, frame_ticks);
+            timer_running = true;
+        }
+        // publish a snapshot and update screen, but only if something
+        // actually changed
+        uint32_t snapshot_start = GAME_PROFILE ? profiler_now() : 0;
+        bool changed = memcmp(state, last_published, game->state_size);
+        if(changed) {
+            memcpy(last_published, state, game->state_size);
+            triple_buffer_write(&render.snapshots, state);
+        }
+        if(GAME_PROFILE) {
+            profiler_stop(&profiler, ProfileStageSnapshot, snapshot_start);
+        }
+        if(changed) {
+            view_port_update(view_port);
+        }
+    }
+    if(GAME_PROFILE) {
+        profiler_log(&profiler, game->name);
+    }
+    if(journal) {
+        if(!replay) {
+            FURI_LOG_I(game->name, "recorded %lu passes", (unsigned long)journal->passes);
+        }
+        game_journal_free(journal);
+    }
+    // free the timer
+    furi_timer_free(timer);
+    // stop the viewport
+    view_port_enabled_set(view_port, false);
+    // remove viewport from gui
+    gui_remove_view_port(gui, view_port);
+    // close the gui
+    furi_record_close(RECORD_GUI);
+    // close notification
+    furi_record_close(RECORD_NOTIFICATION);
+    // delete the viewport
+    view_port_free(view_port);
+    // delete the message queue
+    furi_message_queue_free(event_queue);
+    // free render snapshots and state
+    if(game->free) {
+        game->free(state);
+    }
+    free(snapshots);
+    free(last_published);
+    free(state);
+
+    return 0;
+}
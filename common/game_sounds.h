@@ -0,0 +1,57 @@
+#pragma once
+
+#include <notification/notification.h>
+#include <notification/notification_messages.h>
+
+// sounds shared by the games. one copy here instead of one per app.
+
+const NotificationSequence sequence_player_score = {
+    &message_vibro_on,
+    &message_green_255,
+    &message_note_c4,
+    &message_delay_50,
+    &message_note_e4,
+    &message_delay_50,
+    &message_blue_255,
+    &message_note_g5,
+    &message_delay_50,
+    &message_note_a5,
+    &message_delay_100,
+    &message_note_c6,
+    &message_delay_100,
+    &message_sound_off,
+    &message_vibro_off,
+    &message_green_0,
+    &message_blue_0,
+    NULL,
+};
+
+const NotificationSequence sequence_cpu_score = {
+    &message_vibro_on,
+    &message_green_255,
+    &message_note_ds4,
+    &message_delay_50,
+    &message_note_d4,
+    &message_delay_50,
+    &message_red_255,
+    &message_note_a2,
+    &message_delay_250,
+    &message_sound_off,
+    &message_vibro_off,
+    &message_green_0,
+    &message_blue_0,
+    NULL,
+};
+
+const NotificationSequence sequence_blip = {
+    &message_vibro_on,
+    &message_note_ds4,
+    &message_delay_10,
+    &message_note_f4,
+    &message_delay_10,
+    &message_note_g4,
+    &message_delay_10,
+    &message_sound_off,
+    &message_vibro_off,
+    NULL,
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <furi.h>
+#include <input/input.h>
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// held-key input tracking. the input callback (on the input service thread)
+// only flips bits in a few atomics and never blocks. the game loop reads the
+// whole thing once per pass with input_state_poll.
+
+#define INPUT_KEY_BIT(key) (1u << (key))
+#define INPUT_DIRECTION_KEYS \
+    (INPUT_KEY_BIT(InputKeyUp) | INPUT_KEY_BIT(InputKeyDown) | INPUT_KEY_BIT(InputKeyLeft) | \
+     INPUT_KEY_BIT(InputKeyRight))
+
+typedef struct {
+    atomic_uint held; // bit per InputKey, set while the key is down
+    atomic_uint pressed; // went down since the last poll
+    atomic_uint released; // went up since the last poll
+    // a wake-up is already sitting in the game loop's queue, so more input
+    // just updates the bits above instead of queueing more events
+    atomic_bool wake_pending;
+} InputState;
+
+// what the game loop sees for one pass. a key tapped between two polls shows
+// up in both pressed and released even though it's no longer held.
+typedef struct {
+    uint32_t held;
+    uint32_t pressed;
+    uint32_t released;
+} InputFrame;
+
+static inline void input_state_init(InputState* const input_state) {
+    atomic_init(&input_state->held, 0);
+    atomic_init(&input_state->pressed, 0);
+    atomic_init(&input_state->released, 0);
+    atomic_init(&input_state->wake_pending, false);
+}
+
+// input thread: record one event. short/long/repeat are derived events, the
+// held bit already covers them, so only press and release change anything.
+// returns true if the game loop should be woken.
+static inline bool input_state_feed(InputState* const input_state, const InputEvent* const event) {
+    if(event->key >= InputKeyMAX) {
+        return false;
+    }
+    uint32_t bit = INPUT_KEY_BIT(event->key);
+    if(event->type == InputTypePress) {
+        atomic_fetch_or(&input_state->held, bit);
+        atomic_fetch_or(&input_state->pressed, bit);
+    } else if(event->type == InputTypeRelease) {
+        atomic_fetch_and(&input_state->held, ~bit);
+        atomic_fetch_or(&input_state->released, bit);
+    } else {
+        return false;
+    }
+    // only the first change since the loop last woke needs to queue a wake
+    return !atomic_exchange(&input_state->wake_pending, true);
+}
+
+// game loop: take the current state and clear the edge flags
+static inline InputFrame input_state_poll(InputState* const input_state) {
+    // clear the wake flag first so input arriving from here on queues a new one
+    atomic_store(&input_state->wake_pending, false);
+    InputFrame frame = {
+        .pressed = atomic_exchange(&input_state->pressed, 0),
+        .released = atomic_exchange(&input_state->released, 0),
+        .held = atomic_load(&input_state->held),
+    };
+    return frame;
+}
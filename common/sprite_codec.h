@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// decoders for the frame compression tools/sprite_compiler.py does, see its
+// docstring for the formats. frames are compressed one at a time, so each
+// decodes on its own into a buffer of exactly the frame size. both return
+// false on a stream that doesn't come out at exactly dst_len bytes.
+
+#define SPRITE_CODEC_NONE 0
+#define SPRITE_CODEC_RLE 1
+#define SPRITE_CODEC_HEATSHRINK 2
+
+// same settings as the compiler, and the firmware's icons
+#define HEATSHRINK_WINDOW_BITS 8
+#define HEATSHRINK_LOOKAHEAD_BITS 4
+
+static bool rle_decode(const uint8_t* src, uint16_t src_len, uint8_t* dst, uint16_t dst_len) {
+    uint16_t in = 0, out = 0;
+    while(in < src_len) {
+        uint8_t control = src[in++];
+        if(control < 0x80) {
+            // control + 1 literal bytes
+            uint16_t count = control + 1;
+            if(in + count > src_len || out + count > dst_len) return false;
+            memcpy(&dst[out], &src[in], count);
+            in += count;
+            out += count;
+        } else {
+            // the next byte, control - 0x7e times
+            uint16_t count = control - 0x7E;
+            if(in >= src_len || out + count > dst_len) return false;
+            memset(&dst[out], src[in++], count);
+            out += count;
+        }
+    }
+    return out == dst_len;
+}
+
+// msb first bit reader over a heatshrink stream
+typedef struct {
+    const uint8_t* src;
+    uint16_t len;
+    uint16_t pos; // in bits
+} HeatshrinkBits;
+
+// next 'count' bits, or -1 past the end of the stream
+static inline int16_t heatshrink_bits(HeatshrinkBits* const bits, uint8_t count) {
+    if(bits->pos + count > bits->len * 8) return -1;
+    int16_t value = 0;
+    for(uint8_t i = 0; i < count; i++, bits->pos++) {
+        value = (value << 1) | ((bits->src[bits->pos / 8] >> (7 - bits->pos % 8)) & 1);
+    }
+    return value;
+}
+
+// frames are smaller than the window, so back references point straight
+// into the output, no separate window buffer
+static bool heatshrink_decode(const uint8_t* src, uint16_t src_len, uint8_t* dst, uint16_t dst_len) {
+    HeatshrinkBits bits = {.src = src, .len = src_len};
+    uint16_t out = 0;
+    while(out < dst_len) {
+        int16_t tag = heatshrink_bits(&bits, 1);
+        if(tag < 0) return false;
+        if(tag) {
+            int16_t literal = heatshrink_bits(&bits, 8);
+            if(literal < 0) return false;
+            dst[out++] = literal;
+        } else {
+            int16_t offset = heatshrink_bits(&bits, HEATSHRINK_WINDOW_BITS);
+            int16_t count = heatshrink_bits(&bits, HEATSHRINK_LOOKAHEAD_BITS);
+            if(offset < 0 || count < 0) return false;
+            offset += 1;
+            count += 1;
+            if(offset > out || out + count > dst_len) return false;
+            // byte at a time, a reference may overlap what it's writing
+            for(int16_t i = 0; i < count; i++, out++) {
+                dst[out] = dst[out - offset];
+            }
+        }
+    }
+    // whatever is left is the zero padding of the last byte
+    return true;
+}
+
+static bool sprite_decode(uint8_t codec, const uint8_t* src, uint16_t src_len, uint8_t* dst, uint16_t dst_len) {
+    switch(codec) {
+    case SPRITE_CODEC_NONE:
+        if(src_len != dst_len) return false;
+        memcpy(dst, src, dst_len);
+        return true;
+    case SPRITE_CODEC_RLE:
+        return rle_decode(src, src_len, dst, dst_len);
+    case SPRITE_CODEC_HEATSHRINK:
+        return heatshrink_decode(src, src_len, dst, dst_len);
+    default:
+        return false;
+    }
+}
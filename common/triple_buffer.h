@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// lock-free triple buffer for handing render snapshots from the game loop to
+// the gui thread. one writer, one reader. the writer always has a slot to
+// fill and the reader always has a complete slot to draw, so neither side
+// ever waits on the other. the third slot is the hand-off point, swapped
+// with a single atomic exchange.
+
+#define TRIPLE_BUFFER_INDEX_MASK 0x03
+#define TRIPLE_BUFFER_FRESH 0x04
+
+typedef struct {
+    uint8_t* slots; // 3 * slot_size bytes
+    size_t slot_size;
+    uint8_t back; // writer side only
+    uint8_t front; // reader side only
+    // hand-off slot index, FRESH set when the writer published since the
+    // reader last took it
+    atomic_uint_fast8_t middle;
+} TripleBuffer;
+
+// storage must be 3 * slot_size bytes, all three slots start as copies of
+// the initial snapshot
+static inline void triple_buffer_init(TripleBuffer* const buffer, void* storage, size_t slot_size, const void* initial) {
+    buffer->slots = storage;
+    buffer->slot_size = slot_size;
+    for(uint8_t i = 0; i < 3; i++) {
+        memcpy(&buffer->slots[i * slot_size], initial, slot_size);
+    }
+    buffer->back = 0;
+    buffer->front = 1;
+    atomic_init(&buffer->middle, 2);
+}
+
+// writer: the slot to fill before publishing
+static inline void* triple_buffer_back(TripleBuffer* const buffer) {
+    return &buffer->slots[buffer->back * buffer->slot_size];
+}
+
+// writer: hand the filled slot to the reader and take the old hand-off slot
+static inline void triple_buffer_publish(TripleBuffer* const buffer) {
+    uint_fast8_t old = atomic_exchange_explicit(
+        &buffer->middle, buffer->back | TRIPLE_BUFFER_FRESH, memory_order_acq_rel);
+    buffer->back = old & TRIPLE_BUFFER_INDEX_MASK;
+}
+
+// writer: copy a snapshot in and publish it
+static inline void triple_buffer_write(TripleBuffer* const buffer, const void* snapshot) {
+    memcpy(triple_buffer_back(buffer), snapshot, buffer->slot_size);
+    triple_buffer_publish(buffer);
+}
+
+// reader: newest published snapshot, or the one we had if nothing new came in
+static inline const void* triple_buffer_read(TripleBuffer* const buffer) {
+    if(atomic_load_explicit(&buffer->middle, memory_order_acquire) & TRIPLE_BUFFER_FRESH) {
+        uint_fast8_t old = atomic_exchange_explicit(&buffer->middle, buffer->front, memory_order_acq_rel);
+        buffer->front = old & TRIPLE_BUFFER_INDEX_MASK;
+    }
+    return &buffer->slots[buffer->front * buffer->slot_size];
+}
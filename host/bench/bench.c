@@ -0,0 +1,152 @@
+#include <furi.h>
+
+#include <getopt.h>
+#include <time.h>
+
+#include "../host_sim.h"
+#include "bench.h"
+
+// the Makefile points this at build/ext, same as the sims
+#ifndef HOST_STORAGE_ROOT
+#define HOST_STORAGE_ROOT "ext"
+#endif
+
+// the Makefile links benches with --wrap=malloc etc, so every allocation
+// made by app code lands here first
+static uint64_t alloc_count;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    alloc_count++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    alloc_count++;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    alloc_count++;
+    return __real_realloc(ptr, size);
+}
+
+uint64_t bench_alloc_count(void) {
+    return alloc_count;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+void bench_run(
+    const BenchOptions* options,
+    const char* name,
+    const char* per,
+    size_t entities,
+    BenchRun run,
+    void* context) {
+    if(options->filter && !strstr(name, options->filter)) {
+        return;
+    }
+
+    // warm up, then double the batch until it runs long enough to trust
+    run(context, entities);
+    uint64_t iterations = 1;
+    uint64_t elapsed = 0;
+    uint64_t allocs = 0;
+    for(;;) {
+        uint64_t allocs_before = alloc_count;
+        uint64_t start = now_ns();
+        for(uint64_t i = 0; i < iterations; i++) {
+            run(context, entities);
+        }
+        elapsed = now_ns() - start;
+        allocs = alloc_count - allocs_before;
+        if(elapsed >= options->min_ms * 1000000ull || iterations >= (1ull << 40)) break;
+        iterations *= 2;
+    }
+
+    double ns_per = (double)elapsed / iterations;
+    printf(
+        "{\"bench\":\"%s\",\"entities\":%zu,\"iterations\":%llu,\"ns_per_%s\":%.1f,"
+        "\"ns_per_entity\":%.2f,\"allocs_per_%s\":%.3f}\n",
+        name,
+        entities,
+        (unsigned long long)iterations,
+        per,
+        ns_per,
+        entities ? ns_per / entities : ns_per,
+        per,
+        (double)allocs / iterations);
+    fflush(stdout);
+}
+
+static void usage(const char* prog) {
+    fprintf(
+        stderr,
+        "usage: %s [options]\n"
+        "  -e, --entities LIST   comma separated entity counts (default 1,8,64)\n"
+        "  -t, --min-ms MS       minimum run time per benchmark (default 200)\n"
+        "  -f, --filter TEXT     only run benchmarks whose name contains TEXT\n"
+        "  -S, --storage DIR     directory standing in for the sd card (default %s)\n",
+        prog,
+        HOST_STORAGE_ROOT);
+}
+
+int main(int argc, char** argv) {
+    static const struct option long_options[] = {
+        {"entities", required_argument, NULL, 'e'},
+        {"min-ms", required_argument, NULL, 't'},
+        {"filter", required_argument, NULL, 'f'},
+        {"storage", required_argument, NULL, 'S'},
+        {"help", no_argument, NULL, 'h'},
+        {0},
+    };
+    HostSimConfig config = {
+        .seed = 1,
+        .duration_ms = UINT32_MAX,
+        .render = true,
+        .log_level = FuriLogLevelError,
+        .storage_root = HOST_STORAGE_ROOT,
+    };
+    BenchOptions options = {
+        .entity_counts = {1, 8, 64},
+        .entity_count_len = 3,
+        .min_ms = 200,
+    };
+
+    for(int opt; (opt = getopt_long(argc, argv, "e:t:f:S:h", long_options, NULL)) != -1;) {
+        switch(opt) {
+        case 'e':
+            options.entity_count_len = 0;
+            for(char* tok = strtok(optarg, ","); tok && options.entity_count_len < BENCH_MAX_ENTITY_COUNTS;
+                tok = strtok(NULL, ",")) {
+                size_t count = strtoul(tok, NULL, 10);
+                if(count) options.entity_counts[options.entity_count_len++] = count;
+            }
+            break;
+        case 't':
+            options.min_ms = strtoul(optarg, NULL, 10);
+            break;
+        case 'f':
+            options.filter = optarg;
+            break;
+        case 'S':
+            config.storage_root = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    host_sim_init(&config);
+    bench_app(&options);
+    return 0;
+}
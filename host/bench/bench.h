@@ -0,0 +1,35 @@
+#pragma once
+
+// tiny benchmark harness for the host build. every result is one json
+// object per line on stdout so ci can diff runs.
+
+#include <furi.h>
+
+#define BENCH_MAX_ENTITY_COUNTS 16
+
+typedef struct {
+    size_t entity_counts[BENCH_MAX_ENTITY_COUNTS];
+    size_t entity_count_len;
+    // keep repeating a benchmark until it has run at least this long
+    uint32_t min_ms;
+    // only run benchmarks whose name contains this
+    const char* filter;
+} BenchOptions;
+
+// one call of run() is one tick or one frame over 'entities' things
+typedef void (*BenchRun)(void* context, size_t entities);
+
+// per is "tick" or "frame", it names the ns_per_* field in the output
+void bench_run(
+    const BenchOptions* options,
+    const char* name,
+    const char* per,
+    size_t entities,
+    BenchRun run,
+    void* context);
+
+// allocations made by the code under test, counted by wrapping malloc
+uint64_t bench_alloc_count(void);
+
+// provided by each app's bench file
+void bench_app(const BenchOptions* options);
@@ -0,0 +1,83 @@
+#include "../../pong2/pong2.h"
+#include "../host_sim.h"
+#include "bench.h"
+
+// pong2 hot paths. entities is the number of independent games stepped per
+// tick, so the per-entity number is the cost of one process_step. except
+// for pong2.balls, which is one game with that many balls in play: ticks
+// per second against ball count.
+
+typedef struct {
+    PluginState* states;
+    size_t count;
+    // one game for the multi-ball run
+    PluginState crowd;
+    NotificationApp* notify;
+    Canvas* canvas;
+} PongBench;
+
+static void pong_bench_alloc(PongBench* bench, size_t count) {
+    bench->states = malloc(count * sizeof(PluginState));
+    bench->count = count;
+    for(size_t i = 0; i < count; i++) {
+        pong_state_init(&bench->states[i]);
+        // keep the cpu from parking on the ball forever
+        bench->states[i].paddle_pos[PaddleCpu] = (i * 7) % (SCREEN_HEIGHT - PADDLE_H);
+    }
+}
+
+static void bench_process_step(void* context, size_t entities) {
+    PongBench* bench = context;
+    for(size_t i = 0; i < entities; i++) {
+        process_step(&bench->states[i], bench->notify);
+    }
+}
+
+// the cpu working out a new course, what a paddle hit or a serve costs.
+// always toward the cpu, so it does the full solve
+static void bench_ai_plan(void* context, size_t entities) {
+    PongBench* bench = context;
+    for(size_t i = 0; i < entities; i++) {
+        PluginState* state = &bench->states[i];
+        const Balls* balls = &state->balls;
+        pong_ai_course(&state->ai, 0, balls->x[0], balls->y[0], -abs(balls->xspeed[0]), balls->yspeed[0]);
+        pong_ai_choose(&state->ai, balls->count);
+    }
+}
+
+static void bench_balls(void* context, size_t entities) {
+    PongBench* bench = context;
+    UNUSED(entities);
+    process_step(&bench->crowd, bench->notify);
+}
+
+static void bench_draw_all(void* context, size_t entities) {
+    PongBench* bench = context;
+    for(size_t i = 0; i < entities; i++) {
+        draw_all(&bench->states[i], bench->canvas);
+    }
+}
+
+void bench_app(const BenchOptions* options) {
+    PongBench bench = {
+        .notify = furi_record_open(RECORD_NOTIFICATION),
+        .canvas = host_canvas_alloc(),
+    };
+    for(size_t i = 0; i < options->entity_count_len; i++) {
+        size_t entities = options->entity_counts[i];
+        pong_bench_alloc(&bench, entities);
+        bench_run(options, "pong2.process_step", "tick", entities, bench_process_step, &bench);
+        bench_run(options, "pong2.ai_plan", "course", entities, bench_ai_plan, &bench);
+        if(entities <= BALL_CAPACITY) {
+            pong_state_init(&bench.crowd);
+            bench.crowd.is_muted = true;
+            while(bench.crowd.balls.count < entities) {
+                add_ball(&bench.crowd);
+            }
+            bench_run(options, "pong2.balls", "tick", entities, bench_balls, &bench);
+        }
+        bench_run(options, "pong2.draw_all", "frame", entities, bench_draw_all, &bench);
+        free(bench.states);
+    }
+    host_canvas_free(bench.canvas);
+}
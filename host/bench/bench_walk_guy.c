@@ -0,0 +1,206 @@
+#include "../../walk_guy/walk_guy.h"
+#include "../host_sim.h"
+#include "bench.h"
+
+// walk_guy hot paths. for the draw benchmarks entities is how many players or
+// projectiles go on screen per frame, spread over the whole canvas. the
+// asset benchmarks are frame lookups in the sprite pack from the storage
+// dir, -S points them at a pack built with other settings.
+
+typedef struct {
+    PluginState* states;
+    size_t count;
+    // enough worlds to hold 'count' projectiles between them, for the
+    // projectile benchmarks
+    PluginState* crowds;
+    size_t crowd_count;
+    NotificationApp* notify;
+    Canvas* canvas;
+    // a pack of its own for the asset benchmarks, and every frame in it as
+    // asset,frame pairs
+    AssetPack* pack;
+    uint16_t frames[ASSET_PACK_MAX_FRAMES][2];
+    uint16_t frame_count;
+    uint16_t cursor;
+} WalkBench;
+
+static void walk_bench_alloc(WalkBench* bench, size_t count) {
+    bench->states = malloc(count * sizeof(PluginState));
+    bench->count = count;
+    for(size_t i = 0; i < count; i++) {
+        PluginState* state = &bench->states[i];
+        walk_state_init(state);
+        PlayerTable* player = &state->world.player;
+        ecs_position_set(&player->position[0], (i * 37) % (SCREEN_WIDTH - PLAYER_W), (i * 23) % (SCREEN_HEIGHT - PLAYER_H));
+        player->control[0].dir = i % 4;
+        player->control[0].is_moving = true;
+        player->sprite[0] = (Sprite){i % 4, i % PLAYER_FRAMES};
+        sprite_view_system(state);
+        shoot(state);
+    }
+    bench->crowd_count = (count + PROJECTILE_CAPACITY - 1) / PROJECTILE_CAPACITY;
+    bench->crowds = malloc(bench->crowd_count * sizeof(PluginState));
+    for(size_t i = 0; i < bench->crowd_count; i++) {
+        walk_state_init(&bench->crowds[i]);
+    }
+}
+
+static void walk_bench_free(WalkBench* bench) {
+    for(size_t i = 0; i < bench->count; i++) {
+        walk_state_free(&bench->states[i]);
+    }
+    for(size_t i = 0; i < bench->crowd_count; i++) {
+        walk_state_free(&bench->crowds[i]);
+    }
+    free(bench->states);
+    free(bench->crowds);
+}
+
+// top every crowd back up to 'entities' projectiles in total, spread over
+// the screen and all four directions
+static void fill_crowds(WalkBench* bench, size_t entities) {
+    for(size_t c = 0; c < bench->crowd_count; c++) {
+        World* world = &bench->crowds[c].world;
+        size_t want = entities - c * PROJECTILE_CAPACITY;
+        if(want > PROJECTILE_CAPACITY) want = PROJECTILE_CAPACITY;
+        for(size_t n = world->projectiles.count; n < want; n++) {
+            uint8_t dir = n % 4;
+            spawn_projectile(
+                world, (n * 37) % SCREEN_WIDTH, (n * 23) % SCREEN_HEIGHT,
+                dir_dx[dir] * PROJECTILE_SPEED, dir_dy[dir] * PROJECTILE_SPEED);
+        }
+    }
+}
+
+// a step and the sprite frames after it, what a pass with one step does
+static void bench_process_step(void* context, size_t entities) {
+    WalkBench* bench = context;
+    for(size_t i = 0; i < entities; i++) {
+        process_step(&bench->states[i], bench->notify);
+        sprite_view_system(&bench->states[i]);
+    }
+}
+
+// one logic step of worlds full of projectiles (moving, expiring, hitting
+// enemies) plus respawning the ones that went away, so they stay full
+static void bench_step_projectiles(void* context, size_t entities) {
+    WalkBench* bench = context;
+    for(size_t c = 0; c < bench->crowd_count; c++) {
+        process_step(&bench->crowds[c], bench->notify);
+    }
+    fill_crowds(bench, entities);
+}
+
+static void bench_draw_player(void* context, size_t entities) {
+    WalkBench* bench = context;
+    for(size_t i = 0; i < entities; i++) {
+        const PluginState* state = &bench->states[i];
+        ecs_draw_sprites(bench->canvas, &state->sprite_view, state->world.player.position, state->world.player.sprite, 1, state->render_alpha, 0, 0);
+    }
+}
+
+static void bench_draw_projectiles(void* context, size_t entities) {
+    WalkBench* bench = context;
+    UNUSED(entities);
+    for(size_t c = 0; c < bench->crowd_count; c++) {
+        const ProjectileTable* projectiles = &bench->crowds[c].world.projectiles;
+        ecs_draw_boxes(bench->canvas, projectiles->position, projectiles->collider, projectiles->count, 0, 0, 0);
+    }
+}
+
+static void bench_draw_all(void* context, size_t entities) {
+    WalkBench* bench = context;
+    for(size_t i = 0; i < entities; i++) {
+        draw_all(&bench->states[i], bench->canvas);
+    }
+}
+
+static void walk_bench_pack_init(WalkBench* bench) {
+    bench->pack = asset_pack_alloc(WALK_SPRITES_PATH, SPRITE_W, SPRITE_H);
+    bench->frame_count = 0;
+    for(uint16_t asset = 0; asset < bench->pack->asset_count; asset++) {
+        for(uint16_t frame = 0; frame < bench->pack->assets[asset].frames; frame++) {
+            bench->frames[bench->frame_count][0] = asset;
+            bench->frames[bench->frame_count][1] = frame;
+            bench->frame_count++;
+        }
+    }
+}
+
+// look up 'entities' frames, cycling through the first 'working_set'
+static void asset_lookups(WalkBench* bench, size_t entities, uint16_t working_set) {
+    if(!working_set) return;
+    for(size_t i = 0; i < entities; i++) {
+        uint16_t* pair = bench->frames[bench->cursor++ % working_set];
+        asset_pack_frame(bench->pack, pair[0], pair[1]);
+    }
+}
+
+// a working set that fits the cache, every lookup after the first lap hits
+static void bench_asset_hit(void* context, size_t entities) {
+    WalkBench* bench = context;
+    uint16_t working_set = bench->frame_count < ASSET_CACHE_SLOTS ? bench->frame_count : ASSET_CACHE_SLOTS;
+    asset_lookups(bench, entities, working_set);
+}
+
+// every frame in turn. with more frames than slots lru evicts each one just
+// before it comes round again, so every lookup is a read plus a decode
+static void bench_asset_miss(void* context, size_t entities) {
+    WalkBench* bench = context;
+    asset_lookups(bench, entities, bench->frame_count);
+}
+
+// hit rate of the pack lookups a benchmark made, as its own json line
+static void report_cache(const BenchOptions* options, const char* name, size_t entities, uint32_t hits, uint32_t misses) {
+    if(options->filter && !strstr(name, options->filter)) return;
+    uint32_t lookups = hits + misses;
+    printf(
+        "{\"bench\":\"%s\",\"entities\":%zu,\"cache_slots\":%d,\"cache_hits\":%lu,\"cache_misses\":%lu,"
+        "\"hit_rate\":%.3f}\n",
+        name,
+        entities,
+        ASSET_CACHE_SLOTS,
+        (unsigned long)hits,
+        (unsigned long)misses,
+        lookups ? (double)hits / lookups : 0.0);
+    fflush(stdout);
+}
+
+static void run_asset_bench(const BenchOptions* options, WalkBench* bench, const char* name, size_t entities, BenchRun run) {
+    bench->pack->hits = bench->pack->misses = 0;
+    bench->cursor = 0;
+    bench_run(options, name, "frame", entities, run, bench);
+    report_cache(options, name, entities, bench->pack->hits, bench->pack->misses);
+}
+
+void bench_app(const BenchOptions* options) {
+    WalkBench bench = {
+        .notify = furi_record_open(RECORD_NOTIFICATION),
+        .canvas = host_canvas_alloc(),
+    };
+    walk_bench_pack_init(&bench);
+    for(size_t i = 0; i < options->entity_count_len; i++) {
+        size_t entities = options->entity_counts[i];
+        walk_bench_alloc(&bench, entities);
+        for(size_t s = 0; s < bench.count; s++) {
+            bench.states[s].sprites->hits = bench.states[s].sprites->misses = 0;
+        }
+        bench_run(options, "walk_guy.process_step", "tick", entities, bench_process_step, &bench);
+        uint32_t hits = 0, misses = 0;
+        for(size_t s = 0; s < bench.count; s++) {
+            hits += bench.states[s].sprites->hits;
+            misses += bench.states[s].sprites->misses;
+        }
+        report_cache(options, "walk_guy.process_step", entities, hits, misses);
+        fill_crowds(&bench, entities);
+        bench_run(options, "walk_guy.step_projectiles", "tick", entities, bench_step_projectiles, &bench);
+        bench_run(options, "walk_guy.draw_player", "frame", entities, bench_draw_player, &bench);
+        bench_run(options, "walk_guy.draw_projectiles", "frame", entities, bench_draw_projectiles, &bench);
+        bench_run(options, "walk_guy.draw_all", "frame", entities, bench_draw_all, &bench);
+        run_asset_bench(options, &bench, "walk_guy.asset_hit", entities, bench_asset_hit);
+        run_asset_bench(options, &bench, "walk_guy.asset_miss", entities, bench_asset_miss);
+        walk_bench_free(&bench);
+    }
+    asset_pack_free(bench.pack);
+    host_canvas_free(bench.canvas);
+}
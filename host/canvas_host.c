@@ -0,0 +1,205 @@
+#include <furi.h>
+#include <gui/canvas.h>
+
+#include "host_sim.h"
+
+// 1bpp framebuffer canvas. everything clips to the screen, like u8g2 does.
+
+#define FONT_W 3
+#define FONT_H 5
+#define FONT_ADVANCE (FONT_W + 1)
+
+struct Canvas {
+    uint8_t fb[HOST_FB_SIZE];
+    Color color;
+    Font font;
+};
+
+// 3x5 glyphs for ' ' .. '~', 15 bits each, top left pixel is bit 14.
+// lowercase shares the uppercase shapes, anything missing is a hollow box.
+static const uint16_t font_3x5[95] = {
+    0x0000, 0x2482, 0x7b6f, 0x5f7d, 0x7b6f, 0x52a5, 0x7b6f, 0x2400,
+    0x1491, 0x4494, 0x0aa8, 0x05d0, 0x0014, 0x01c0, 0x0002, 0x12a4,
+    0x7b6f, 0x2c97, 0x73e7, 0x72cf, 0x5bc9, 0x79cf, 0x79ef, 0x7292,
+    0x7bef, 0x7bcf, 0x0410, 0x7b6f, 0x1511, 0x0e38, 0x4454, 0x6282,
+    0x7b6f, 0x2bed, 0x6bae, 0x3923, 0x6b6e, 0x79a7, 0x79a4, 0x396b,
+    0x5bed, 0x7497, 0x126a, 0x5bad, 0x4927, 0x5fed, 0x6b6d, 0x2b6a,
+    0x6ba4, 0x2b73, 0x6bad, 0x388e, 0x7492, 0x5b6f, 0x5b6a, 0x5bfd,
+    0x5aad, 0x5a92, 0x72a7, 0x6926, 0x7b6f, 0x324b, 0x7b6f, 0x0007,
+    0x7b6f, 0x2bed, 0x6bae, 0x3923, 0x6b6e, 0x79a7, 0x79a4, 0x396b,
+    0x5bed, 0x7497, 0x126a, 0x5bad, 0x4927, 0x5fed, 0x6b6d, 0x2b6a,
+    0x6ba4, 0x2b73, 0x6bad, 0x388e, 0x7492, 0x5b6f, 0x5b6a, 0x5bfd,
+    0x5aad, 0x5a92, 0x72a7, 0x7b6f, 0x7b6f, 0x7b6f, 0x7b6f,
+};
+
+Canvas* host_canvas_alloc(void) {
+    Canvas* canvas = malloc(sizeof(Canvas));
+    host_canvas_reset(canvas);
+    return canvas;
+}
+
+void host_canvas_free(Canvas* canvas) {
+    free(canvas);
+}
+
+void host_canvas_reset(Canvas* canvas) {
+    memset(canvas->fb, 0, sizeof(canvas->fb));
+    canvas->color = ColorBlack;
+    canvas->font = FontPrimary;
+}
+
+const uint8_t* host_canvas_buffer(Canvas* canvas) {
+    return canvas->fb;
+}
+
+uint8_t canvas_width(Canvas* canvas) {
+    UNUSED(canvas);
+    return HOST_SCREEN_WIDTH;
+}
+
+uint8_t canvas_height(Canvas* canvas) {
+    UNUSED(canvas);
+    return HOST_SCREEN_HEIGHT;
+}
+
+void canvas_clear(Canvas* canvas) {
+    memset(canvas->fb, 0, sizeof(canvas->fb));
+}
+
+void canvas_set_color(Canvas* canvas, Color color) {
+    canvas->color = color;
+}
+
+void canvas_set_font(Canvas* canvas, Font font) {
+    canvas->font = font;
+}
+
+static inline void put_pixel(Canvas* canvas, int x, int y) {
+    if(x < 0 || y < 0 || x >= HOST_SCREEN_WIDTH || y >= HOST_SCREEN_HEIGHT) {
+        return;
+    }
+    uint8_t* byte = &canvas->fb[y * HOST_FB_STRIDE + x / 8];
+    uint8_t bit = 1 << (x % 8);
+    if(canvas->color == ColorXOR) {
+        *byte ^= bit;
+    } else if(canvas->color == ColorBlack) {
+        *byte |= bit;
+    } else {
+        *byte &= ~bit;
+    }
+}
+
+void canvas_draw_dot(Canvas* canvas, uint8_t x, uint8_t y) {
+    put_pixel(canvas, x, y);
+}
+
+void canvas_draw_box(Canvas* canvas, uint8_t x, uint8_t y, uint8_t width, uint8_t height) {
+    for(int row = y; row < y + height; row++) {
+        for(int col = x; col < x + width; col++) {
+            put_pixel(canvas, col, row);
+        }
+    }
+}
+
+void canvas_draw_frame(Canvas* canvas, uint8_t x, uint8_t y, uint8_t width, uint8_t height) {
+    if(!width || !height) return;
+    for(int col = x; col < x + width; col++) {
+        put_pixel(canvas, col, y);
+        if(height > 1) put_pixel(canvas, col, y + height - 1);
+    }
+    for(int row = y + 1; row < y + height - 1; row++) {
+        put_pixel(canvas, x, row);
+        if(width > 1) put_pixel(canvas, x + width - 1, row);
+    }
+}
+
+void canvas_draw_line(Canvas* canvas, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2) {
+    int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+    int dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+    int err = dx + dy;
+    int x = x1, y = y1;
+    for(;;) {
+        put_pixel(canvas, x, y);
+        if(x == x2 && y == y2) break;
+        int e2 = 2 * err;
+        if(e2 >= dy) {
+            err += dy;
+            x += sx;
+        }
+        if(e2 <= dx) {
+            err += dx;
+            y += sy;
+        }
+    }
+}
+
+void canvas_draw_xbm(
+    Canvas* canvas,
+    uint8_t x,
+    uint8_t y,
+    uint8_t w,
+    uint8_t h,
+    const uint8_t* bitmap) {
+    uint8_t row_bytes = (w + 7) / 8;
+    for(int row = 0; row < h; row++) {
+        for(int col = 0; col < w; col++) {
+            if(bitmap[row * row_bytes + col / 8] & (1 << (col % 8))) {
+                put_pixel(canvas, x + col, y + row);
+            }
+        }
+    }
+}
+
+uint8_t canvas_current_font_height(Canvas* canvas) {
+    UNUSED(canvas);
+    return FONT_H;
+}
+
+uint16_t canvas_string_width(Canvas* canvas, const char* str) {
+    UNUSED(canvas);
+    size_t len = strlen(str);
+    return len ? len * FONT_ADVANCE - 1 : 0;
+}
+
+// y is the baseline, same as the firmware
+static void draw_text(Canvas* canvas, int x, int y, const char* str) {
+    int pen_x = x;
+    for(; *str; str++, pen_x += FONT_ADVANCE) {
+        char c = *str;
+        if(c < ' ' || c > '~') c = '?';
+        uint16_t glyph = font_3x5[c - ' '];
+        for(int row = 0; row < FONT_H; row++) {
+            for(int col = 0; col < FONT_W; col++) {
+                if(glyph & (1 << (14 - (row * FONT_W + col)))) {
+                    put_pixel(canvas, pen_x + col, y - FONT_H + row);
+                }
+            }
+        }
+    }
+}
+
+void canvas_draw_str(Canvas* canvas, uint8_t x, uint8_t y, const char* str) {
+    draw_text(canvas, x, y, str);
+}
+
+void canvas_draw_str_aligned(
+    Canvas* canvas,
+    uint8_t x,
+    uint8_t y,
+    Align horizontal,
+    Align vertical,
+    const char* str) {
+    int width = canvas_string_width(canvas, str);
+    int px = x, py = y;
+    if(horizontal == AlignRight) {
+        px -= width;
+    } else if(horizontal == AlignCenter) {
+        px -= width / 2;
+    }
+    if(vertical == AlignTop) {
+        py += FONT_H;
+    } else if(vertical == AlignCenter) {
+        py += FONT_H / 2;
+    }
+    draw_text(canvas, px, py, str);
+}
@@ -0,0 +1,294 @@
+#include <furi.h>
+#include <furi_hal_random.h>
+#include <gui/gui.h>
+#include <notification/notification.h>
+#include <storage/storage.h>
+
+#include <stdarg.h>
+
+#include "host_sim.h"
+
+// single threaded stand-in for the furi kernel. the app thread is the only
+// thread: whenever it waits on a queue, virtual time jumps to the next thing
+// that would have woken it (a timer, a scripted input or the end of the run)
+// and the gui "thread" gets to redraw.
+
+#define HOST_MAX_TIMERS 8
+
+struct FuriMessageQueue {
+    uint8_t* buffer;
+    uint32_t msg_size;
+    uint32_t capacity;
+    uint32_t head;
+    uint32_t count;
+};
+
+struct FuriTimer {
+    FuriTimerCallback callback;
+    FuriTimerType type;
+    void* context;
+    uint32_t period;
+    uint32_t next_due;
+    bool running;
+};
+
+static HostSimConfig sim_config = {
+    .seed = 1,
+    .duration_ms = 10000,
+    .render = true,
+    .log_level = FuriLogLevelWarn,
+};
+static HostSimStats sim_stats;
+static uint32_t random_state = 1;
+static size_t script_pos;
+static bool exit_sent;
+static FuriTimer* timers[HOST_MAX_TIMERS];
+
+extern Gui* host_gui_record(void);
+extern NotificationApp* host_notification_record(void);
+extern Storage* host_storage_record(void);
+
+void host_sim_init(const HostSimConfig* config) {
+    sim_config = *config;
+    memset(&sim_stats, 0, sizeof(sim_stats));
+    random_state = config->seed ? config->seed : 1;
+    script_pos = 0;
+    exit_sent = false;
+}
+
+const HostSimConfig* host_sim_config(void) {
+    return &sim_config;
+}
+
+HostSimStats* host_sim_stats(void) {
+    return &sim_stats;
+}
+
+// log
+
+void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...) {
+    static const char level_char[] = " EWIDT";
+    if(level > sim_config.log_level) {
+        return;
+    }
+    fprintf(stderr, "%u [%c][%s] ", sim_stats.now_ms, level_char[level], tag);
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+// random, xorshift32 so runs are repeatable per seed
+
+uint32_t furi_hal_random_get(void) {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+// kernel
+
+uint32_t furi_kernel_get_tick_frequency(void) {
+    return 1000;
+}
+
+uint32_t furi_get_tick(void) {
+    return sim_stats.now_ms;
+}
+
+// records
+
+void* furi_record_open(const char* name) {
+    if(!strcmp(name, RECORD_GUI)) return host_gui_record();
+    if(!strcmp(name, RECORD_NOTIFICATION)) return host_notification_record();
+    if(!strcmp(name, RECORD_STORAGE)) return host_storage_record();
+    FURI_LOG_E("host", "no stand-in for record '%s'", name);
+    abort();
+}
+
+void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+// message queue
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size) {
+    FuriMessageQueue* queue = malloc(sizeof(FuriMessageQueue));
+    queue->buffer = malloc(msg_count * msg_size);
+    queue->msg_size = msg_size;
+    queue->capacity = msg_count;
+    queue->head = 0;
+    queue->count = 0;
+    return queue;
+}
+
+void furi_message_queue_free(FuriMessageQueue* instance) {
+    free(instance->buffer);
+    free(instance);
+}
+
+uint32_t furi_message_queue_get_count(FuriMessageQueue* instance) {
+    return instance->count;
+}
+
+FuriStatus furi_message_queue_put(FuriMessageQueue* instance, const void* msg_ptr, uint32_t timeout) {
+    if(instance->count == instance->capacity) {
+        // nobody else can drain the queue while we wait, so a blocking put
+        // on a full queue would hang forever. count it and drop instead.
+        if(timeout) {
+            FURI_LOG_W("host", "blocking put on a full queue, event dropped");
+        }
+        sim_stats.queue_drops++;
+        return FuriStatusErrorTimeout;
+    }
+    uint32_t tail = (instance->head + instance->count) % instance->capacity;
+    memcpy(&instance->buffer[tail * instance->msg_size], msg_ptr, instance->msg_size);
+    instance->count++;
+    return FuriStatusOk;
+}
+
+static bool queue_pop(FuriMessageQueue* instance, void* msg_ptr) {
+    if(!instance->count) {
+        return false;
+    }
+    memcpy(msg_ptr, &instance->buffer[instance->head * instance->msg_size], instance->msg_size);
+    instance->head = (instance->head + 1) % instance->capacity;
+    instance->count--;
+    return true;
+}
+
+// scheduler
+
+// earliest virtual time something is due, UINT32_MAX if nothing ever is
+static uint32_t next_due_time(void) {
+    uint32_t next = UINT32_MAX;
+    for(size_t i = 0; i < HOST_MAX_TIMERS; i++) {
+        if(timers[i] && timers[i]->running && timers[i]->next_due < next) {
+            next = timers[i]->next_due;
+        }
+    }
+    if(script_pos < sim_config.script_len && sim_config.script[script_pos].time_ms < next) {
+        next = sim_config.script[script_pos].time_ms;
+    }
+    if(!exit_sent && sim_config.duration_ms < next) {
+        next = sim_config.duration_ms;
+    }
+    return next;
+}
+
+static void send_key(InputKey key, InputType type) {
+    InputEvent event = {.sequence = sim_stats.inputs, .key = key, .type = type};
+    sim_stats.inputs++;
+    host_gui_dispatch_input(&event);
+}
+
+// fire everything due at the current time
+static void run_due(void) {
+    uint32_t now = sim_stats.now_ms;
+    while(script_pos < sim_config.script_len && sim_config.script[script_pos].time_ms <= now) {
+        send_key(sim_config.script[script_pos].key, sim_config.script[script_pos].type);
+        script_pos++;
+    }
+    for(size_t i = 0; i < HOST_MAX_TIMERS; i++) {
+        FuriTimer* timer = timers[i];
+        if(timer && timer->running && timer->next_due <= now) {
+            if(timer->type == FuriTimerTypePeriodic) {
+                timer->next_due += timer->period;
+            } else {
+                timer->running = false;
+            }
+            sim_stats.ticks++;
+            timer->callback(timer->context);
+        }
+    }
+    if(!exit_sent && sim_config.duration_ms <= now) {
+        exit_sent = true;
+        send_key(InputKeyBack, InputTypePress);
+        send_key(InputKeyBack, InputTypeShort);
+        send_key(InputKeyBack, InputTypeRelease);
+    }
+}
+
+// let virtual time pass until 'until', firing what comes due on the way.
+// returns early (true) as soon as the queue has something in it.
+static bool advance_until(FuriMessageQueue* queue, uint32_t until) {
+    while(!(queue && queue->count)) {
+        uint32_t next = next_due_time();
+        if(next > until) {
+            if(until != UINT32_MAX) sim_stats.now_ms = until;
+            return false;
+        }
+        if(next > sim_stats.now_ms) sim_stats.now_ms = next;
+        run_due();
+    }
+    return true;
+}
+
+FuriStatus furi_message_queue_get(FuriMessageQueue* instance, void* msg_ptr, uint32_t timeout) {
+    // the app isn't holding anything between loop iterations, so this is
+    // where the gui gets its turn
+    host_gui_flush();
+    if(queue_pop(instance, msg_ptr)) {
+        return FuriStatusOk;
+    }
+    uint32_t until = (timeout == FuriWaitForever) ? UINT32_MAX : sim_stats.now_ms + timeout;
+    if(timeout && advance_until(instance, until)) {
+        queue_pop(instance, msg_ptr);
+        return FuriStatusOk;
+    }
+    if(timeout == FuriWaitForever) {
+        FURI_LOG_E("host", "queue wait would block forever, nothing left to wake it");
+        exit(2);
+    }
+    return FuriStatusErrorTimeout;
+}
+
+void furi_delay_ms(uint32_t milliseconds) {
+    advance_until(NULL, sim_stats.now_ms + milliseconds);
+}
+
+void furi_delay_tick(uint32_t ticks) {
+    furi_delay_ms(ticks);
+}
+
+// timer
+
+FuriTimer* furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void* context) {
+    FuriTimer* timer = calloc(1, sizeof(FuriTimer));
+    timer->callback = func;
+    timer->type = type;
+    timer->context = context;
+    for(size_t i = 0; i < HOST_MAX_TIMERS; i++) {
+        if(!timers[i]) {
+            timers[i] = timer;
+            return timer;
+        }
+    }
+    FURI_LOG_E("host", "out of timer slots");
+    abort();
+}
+
+void furi_timer_free(FuriTimer* instance) {
+    for(size_t i = 0; i < HOST_MAX_TIMERS; i++) {
+        if(timers[i] == instance) timers[i] = NULL;
+    }
+    free(instance);
+}
+
+FuriStatus furi_timer_start(FuriTimer* instance, uint32_t ticks) {
+    instance->period = ticks ? ticks : 1;
+    instance->next_due = sim_stats.now_ms + instance->period;
+    instance->running = true;
+    return FuriStatusOk;
+}
+
+FuriStatus furi_timer_stop(FuriTimer* instance) {
+    instance->running = false;
+    return FuriStatusOk;
+}
+
+uint32_t furi_timer_is_running(FuriTimer* instance) {
+    return instance->running;
+}
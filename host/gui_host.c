@@ -0,0 +1,113 @@
+#include <furi.h>
+#include <gui/gui.h>
+
+#include "host_sim.h"
+
+// gui stand-in. view_port_update only marks the port dirty, the actual redraw
+// happens in host_gui_flush when the app next waits on its queue, the same
+// point where the real gui thread would get to draw the newest snapshot.
+
+#define HOST_MAX_VIEW_PORTS 4
+
+struct ViewPort {
+    ViewPortDrawCallback draw_callback;
+    void* draw_context;
+    ViewPortInputCallback input_callback;
+    void* input_context;
+    bool enabled;
+    bool dirty;
+};
+
+struct Gui {
+    ViewPort* ports[HOST_MAX_VIEW_PORTS];
+    Canvas* canvas;
+};
+
+static Gui gui;
+
+Gui* host_gui_record(void) {
+    if(!gui.canvas) {
+        gui.canvas = host_canvas_alloc();
+    }
+    return &gui;
+}
+
+ViewPort* view_port_alloc(void) {
+    ViewPort* view_port = calloc(1, sizeof(ViewPort));
+    view_port->enabled = true;
+    return view_port;
+}
+
+void view_port_free(ViewPort* view_port) {
+    free(view_port);
+}
+
+void view_port_enabled_set(ViewPort* view_port, bool enabled) {
+    view_port->enabled = enabled;
+}
+
+bool view_port_is_enabled(ViewPort* view_port) {
+    return view_port->enabled;
+}
+
+void view_port_draw_callback_set(ViewPort* view_port, ViewPortDrawCallback callback, void* context) {
+    view_port->draw_callback = callback;
+    view_port->draw_context = context;
+}
+
+void view_port_input_callback_set(ViewPort* view_port, ViewPortInputCallback callback, void* context) {
+    view_port->input_callback = callback;
+    view_port->input_context = context;
+}
+
+void view_port_update(ViewPort* view_port) {
+    view_port->dirty = true;
+}
+
+void gui_add_view_port(Gui* instance, ViewPort* view_port, GuiLayer layer) {
+    UNUSED(layer);
+    for(size_t i = 0; i < HOST_MAX_VIEW_PORTS; i++) {
+        if(!instance->ports[i]) {
+            instance->ports[i] = view_port;
+            view_port->dirty = true;
+            return;
+        }
+    }
+    FURI_LOG_E("host", "out of view port slots");
+    abort();
+}
+
+void gui_remove_view_port(Gui* instance, ViewPort* view_port) {
+    for(size_t i = 0; i < HOST_MAX_VIEW_PORTS; i++) {
+        if(instance->ports[i] == view_port) instance->ports[i] = NULL;
+    }
+}
+
+void host_gui_flush(void) {
+    const HostSimConfig* config = host_sim_config();
+    for(size_t i = 0; i < HOST_MAX_VIEW_PORTS; i++) {
+        ViewPort* view_port = gui.ports[i];
+        if(!view_port || !view_port->dirty || !view_port->enabled) continue;
+        view_port->dirty = false;
+        if(!config->render || !view_port->draw_callback) continue;
+
+        host_canvas_reset(gui.canvas);
+        view_port->draw_callback(gui.canvas, view_port->draw_context);
+        HostSimStats* stats = host_sim_stats();
+        if(config->on_frame) {
+            config->on_frame(host_canvas_buffer(gui.canvas), stats->frames, config->on_frame_context);
+        }
+        stats->frames++;
+    }
+}
+
+void host_gui_dispatch_input(InputEvent* event) {
+    // input goes to the most recently added port, like the top of a layer
+    for(size_t i = HOST_MAX_VIEW_PORTS; i-- > 0;) {
+        ViewPort* view_port = gui.ports[i];
+        if(view_port && view_port->enabled && view_port->input_callback) {
+            view_port->input_callback(event, view_port->input_context);
+            return;
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#include <furi.h>
+
+#include <ctype.h>
+
+#include "host_sim.h"
+
+static const char* const key_names[InputKeyMAX] = {"up", "down", "right", "left", "ok", "back"};
+static const char* const type_names[InputTypeMAX] = {"press", "release", "short", "long", "repeat"};
+
+static int lookup(const char* const* names, int count, const char* word) {
+    for(int i = 0; i < count; i++) {
+        if(!strcmp(names[i], word)) return i;
+    }
+    return -1;
+}
+
+// insertion sort, stable so events at the same time keep file order
+static void sort_events(HostScriptEvent* events, size_t count) {
+    for(size_t i = 1; i < count; i++) {
+        HostScriptEvent event = events[i];
+        size_t j = i;
+        for(; j > 0 && events[j - 1].time_ms > event.time_ms; j--) {
+            events[j] = events[j - 1];
+        }
+        events[j] = event;
+    }
+}
+
+bool host_script_load(const char* path, HostScriptEvent** events, size_t* count, uint32_t* end_ms) {
+    FILE* file = fopen(path, "r");
+    if(!file) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    size_t capacity = 64;
+    *events = malloc(capacity * sizeof(HostScriptEvent));
+    *count = 0;
+
+    char line[128];
+    for(unsigned line_no = 1; fgets(line, sizeof(line), file); line_no++) {
+        char* hash = strchr(line, '#');
+        if(hash) *hash = '\0';
+        char first[32], key[32], type[32];
+        int fields = sscanf(line, "%31s %31s %31s", first, key, type);
+        if(fields <= 0) continue;
+        if(!strcmp(first, "end") && fields == 2) {
+            *end_ms = strtoul(key, NULL, 10);
+            continue;
+        }
+        int k = fields == 3 ? lookup(key_names, InputKeyMAX, key) : -1;
+        int t = fields == 3 ? lookup(type_names, InputTypeMAX, type) : -1;
+        if(!isdigit((unsigned char)first[0]) || k < 0 || t < 0) {
+            fprintf(stderr, "%s:%u: expected '<time_ms> <key> <type>'\n", path, line_no);
+            fclose(file);
+            free(*events);
+            return false;
+        }
+        if(*count == capacity) {
+            capacity *= 2;
+            *events = realloc(*events, capacity * sizeof(HostScriptEvent));
+        }
+        (*events)[(*count)++] =
+            (HostScriptEvent){.time_ms = strtoul(first, NULL, 10), .key = k, .type = t};
+    }
+    fclose(file);
+    sort_events(*events, *count);
+    return true;
+}
+
+void host_fb_write_pbm(const uint8_t* fb, FILE* out) {
+    fprintf(out, "P4\n%d %d\n", HOST_SCREEN_WIDTH, HOST_SCREEN_HEIGHT);
+    // pbm wants msb first, the framebuffer is lsb first
+    for(size_t i = 0; i < HOST_FB_SIZE; i++) {
+        uint8_t b = fb[i], r = 0;
+        for(int bit = 0; bit < 8; bit++) {
+            r |= ((b >> bit) & 1) << (7 - bit);
+        }
+        fputc(r, out);
+    }
+}
+
+bool host_fb_read_pbm(uint8_t* fb, FILE* in) {
+    int w, h;
+    if(fscanf(in, "P4 %d %d", &w, &h) != 2 || w != HOST_SCREEN_WIDTH || h != HOST_SCREEN_HEIGHT) {
+        return false;
+    }
+    // exactly one whitespace byte between the header and the bits
+    fgetc(in);
+    for(size_t i = 0; i < HOST_FB_SIZE; i++) {
+        int b = fgetc(in);
+        if(b == EOF) return false;
+        uint8_t r = 0;
+        for(int bit = 0; bit < 8; bit++) {
+            r |= ((b >> bit) & 1) << (7 - bit);
+        }
+        fb[i] = r;
+    }
+    return true;
+}
+
+uint64_t host_fb_hash(const uint8_t* fb) {
+    // 64 bit fnv-1a
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for(size_t i = 0; i < HOST_FB_SIZE; i++) {
+        hash = (hash ^ fb[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+void host_fb_print(const uint8_t* fb, FILE* out) {
+    for(uint8_t y = 0; y < HOST_SCREEN_HEIGHT; y++) {
+        for(uint8_t x = 0; x < HOST_SCREEN_WIDTH; x++) {
+            fputc(host_fb_get(fb, x, y) ? '#' : '.', out);
+        }
+        fputc('\n', out);
+    }
+}
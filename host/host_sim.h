@@ -0,0 +1,81 @@
+#pragma once
+
+// control surface of the host simulator. apps never include this, only the
+// harness (sim_main.c and friends) does.
+
+#include <furi.h>
+#include <gui/canvas.h>
+#include <input/input.h>
+
+#define HOST_SCREEN_WIDTH 128
+#define HOST_SCREEN_HEIGHT 64
+#define HOST_FB_STRIDE (HOST_SCREEN_WIDTH / 8)
+#define HOST_FB_SIZE (HOST_FB_STRIDE * HOST_SCREEN_HEIGHT)
+
+// one scripted input, delivered through the view port input callback the
+// same way the gui thread would
+typedef struct {
+    uint32_t time_ms;
+    InputKey key;
+    InputType type;
+} HostScriptEvent;
+
+// called after every redraw. framebuffer is row-major, HOST_FB_STRIDE bytes
+// per row, lsb is the leftmost pixel.
+typedef void (*HostFrameCallback)(const uint8_t* framebuffer, uint64_t frame, void* context);
+
+typedef struct {
+    uint32_t seed;
+    // back gets pressed at this virtual time so the app leaves its loop
+    uint32_t duration_ms;
+    // false skips draw callbacks entirely, for pure logic throughput
+    bool render;
+    FuriLogLevel log_level;
+    const HostScriptEvent* script;
+    size_t script_len;
+    HostFrameCallback on_frame;
+    void* on_frame_context;
+    // local directory standing in for the sd card, /ext/foo is
+    // storage_root/foo. NULL means no sd card.
+    const char* storage_root;
+} HostSimConfig;
+
+typedef struct {
+    uint32_t now_ms;
+    uint64_t ticks; // timer callbacks fired
+    uint64_t frames;
+    uint64_t inputs;
+    uint64_t notifications;
+    uint64_t queue_drops;
+} HostSimStats;
+
+void host_sim_init(const HostSimConfig* config);
+const HostSimConfig* host_sim_config(void);
+HostSimStats* host_sim_stats(void);
+
+// scheduler hooks between furi_host.c and gui_host.c
+void host_gui_flush(void);
+void host_gui_dispatch_input(InputEvent* event);
+
+// canvas
+Canvas* host_canvas_alloc(void);
+void host_canvas_free(Canvas* canvas);
+// clear to white, black pen, primary font. the gui does this before every draw.
+void host_canvas_reset(Canvas* canvas);
+const uint8_t* host_canvas_buffer(Canvas* canvas);
+
+static inline bool host_fb_get(const uint8_t* fb, uint8_t x, uint8_t y) {
+    return fb[y * HOST_FB_STRIDE + x / 8] & (1 << (x % 8));
+}
+
+// script files: one event per line, "<time_ms> <key> <type>", plus an
+// optional "end <time_ms>". keys are up/down/left/right/ok/back, types are
+// press/release/short/long/repeat. '#' starts a comment.
+bool host_script_load(const char* path, HostScriptEvent** events, size_t* count, uint32_t* end_ms);
+
+void host_fb_write_pbm(const uint8_t* fb, FILE* out);
+// reads what host_fb_write_pbm wrote, false for anything else
+bool host_fb_read_pbm(uint8_t* fb, FILE* in);
+void host_fb_print(const uint8_t* fb, FILE* out);
+// fingerprint of a frame, for golden files
+uint64_t host_fb_hash(const uint8_t* fb);
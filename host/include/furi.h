@@ -0,0 +1,86 @@
+#pragma once
+
+// host stand-in for the firmware's furi.h. only the parts the apps in this
+// repo use, backed by a single threaded simulator (see host/furi_host.c).
+// time is virtual: it only moves when the app waits on a queue or delays.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define FURI_HOST 1
+
+#define UNUSED(x) (void)(x)
+
+#define furi_assert(x) assert(x)
+#define furi_check(x) assert(x)
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+    FuriStatusErrorTimeout = -2,
+    FuriStatusErrorResource = -3,
+    FuriStatusErrorParameter = -4,
+    FuriStatusErrorNoMemory = -5,
+    FuriStatusErrorISR = -6,
+} FuriStatus;
+
+#define FuriWaitForever 0xFFFFFFFFU
+
+// log
+typedef enum {
+    FuriLogLevelNone = 0,
+    FuriLogLevelError = 1,
+    FuriLogLevelWarn = 2,
+    FuriLogLevelInfo = 3,
+    FuriLogLevelDebug = 4,
+    FuriLogLevelTrace = 5,
+} FuriLogLevel;
+
+void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define FURI_LOG_E(tag, format, ...) furi_log_print_format(FuriLogLevelError, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_W(tag, format, ...) furi_log_print_format(FuriLogLevelWarn, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_I(tag, format, ...) furi_log_print_format(FuriLogLevelInfo, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_D(tag, format, ...) furi_log_print_format(FuriLogLevelDebug, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_T(tag, format, ...) furi_log_print_format(FuriLogLevelTrace, tag, format, ##__VA_ARGS__)
+
+// kernel
+uint32_t furi_kernel_get_tick_frequency(void);
+uint32_t furi_get_tick(void);
+void furi_delay_ms(uint32_t milliseconds);
+void furi_delay_tick(uint32_t ticks);
+
+// record
+void* furi_record_open(const char* name);
+void furi_record_close(const char* name);
+
+// message queue
+typedef struct FuriMessageQueue FuriMessageQueue;
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size);
+void furi_message_queue_free(FuriMessageQueue* instance);
+FuriStatus furi_message_queue_put(FuriMessageQueue* instance, const void* msg_ptr, uint32_t timeout);
+FuriStatus furi_message_queue_get(FuriMessageQueue* instance, void* msg_ptr, uint32_t timeout);
+uint32_t furi_message_queue_get_count(FuriMessageQueue* instance);
+
+// timer
+typedef void (*FuriTimerCallback)(void* context);
+
+typedef enum {
+    FuriTimerTypeOnce = 0,
+    FuriTimerTypePeriodic = 1,
+} FuriTimerType;
+
+typedef struct FuriTimer FuriTimer;
+
+FuriTimer* furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void* context);
+void furi_timer_free(FuriTimer* instance);
+FuriStatus furi_timer_start(FuriTimer* instance, uint32_t ticks);
+FuriStatus furi_timer_stop(FuriTimer* instance);
+uint32_t furi_timer_is_running(FuriTimer* instance);
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <stdint.h>
+
+// host stand-in: seedable and deterministic, see host_sim_config.seed
+uint32_t furi_hal_random_get(void);
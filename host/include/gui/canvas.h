@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// host stand-in canvas: an in-memory 128x64 1bpp framebuffer.
+// text uses a built-in 3x5 font, so it lands in roughly the same place as
+// on the device but isn't pixel identical.
+
+typedef enum {
+    ColorWhite = 0x00,
+    ColorBlack = 0x01,
+    ColorXOR = 0x02,
+} Color;
+
+typedef enum {
+    FontPrimary,
+    FontSecondary,
+    FontKeyboard,
+    FontBigNumbers,
+    FontTotalNumber,
+} Font;
+
+typedef enum {
+    AlignLeft,
+    AlignRight,
+    AlignTop,
+    AlignBottom,
+    AlignCenter,
+} Align;
+
+typedef struct Canvas Canvas;
+
+uint8_t canvas_width(Canvas* canvas);
+uint8_t canvas_height(Canvas* canvas);
+void canvas_clear(Canvas* canvas);
+void canvas_set_color(Canvas* canvas, Color color);
+void canvas_set_font(Canvas* canvas, Font font);
+void canvas_draw_str(Canvas* canvas, uint8_t x, uint8_t y, const char* str);
+void canvas_draw_str_aligned(
+    Canvas* canvas,
+    uint8_t x,
+    uint8_t y,
+    Align horizontal,
+    Align vertical,
+    const char* str);
+uint16_t canvas_string_width(Canvas* canvas, const char* str);
+uint8_t canvas_current_font_height(Canvas* canvas);
+void canvas_draw_dot(Canvas* canvas, uint8_t x, uint8_t y);
+void canvas_draw_box(Canvas* canvas, uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+void canvas_draw_frame(Canvas* canvas, uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+void canvas_draw_line(Canvas* canvas, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
+void canvas_draw_xbm(
+    Canvas* canvas,
+    uint8_t x,
+    uint8_t y,
+    uint8_t w,
+    uint8_t h,
+    const uint8_t* bitmap);
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "canvas.h"
+#include "view_port.h"
+
+#define RECORD_GUI "gui"
+
+typedef enum {
+    GuiLayerDesktop,
+    GuiLayerWindow,
+    GuiLayerStatusBarLeft,
+    GuiLayerStatusBarRight,
+    GuiLayerFullscreen,
+    GuiLayerMAX,
+} GuiLayer;
+
+typedef struct Gui Gui;
+
+void gui_add_view_port(Gui* gui, ViewPort* view_port, GuiLayer layer);
+void gui_remove_view_port(Gui* gui, ViewPort* view_port);
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include <input/input.h>
+#include "canvas.h"
+
+typedef struct ViewPort ViewPort;
+
+typedef void (*ViewPortDrawCallback)(Canvas* canvas, void* context);
+typedef void (*ViewPortInputCallback)(InputEvent* event, void* context);
+
+ViewPort* view_port_alloc(void);
+void view_port_free(ViewPort* view_port);
+void view_port_enabled_set(ViewPort* view_port, bool enabled);
+bool view_port_is_enabled(ViewPort* view_port);
+void view_port_draw_callback_set(ViewPort* view_port, ViewPortDrawCallback callback, void* context);
+void view_port_input_callback_set(ViewPort* view_port, ViewPortInputCallback callback, void* context);
+void view_port_update(ViewPort* view_port);
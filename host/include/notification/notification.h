@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+
+#define RECORD_NOTIFICATION "notification"
+
+// the host stand-in only needs messages to be distinct, it never plays them
+typedef struct {
+    const char* name;
+} NotificationMessage;
+
+typedef const NotificationMessage* NotificationSequence[];
+
+typedef struct NotificationApp NotificationApp;
+
+void notification_message(NotificationApp* app, const NotificationSequence* sequence);
+void notification_message_block(NotificationApp* app, const NotificationSequence* sequence);
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "notification.h"
+
+// the firmware messages apps are likely to use, as an x-macro so
+// host/notification_host.c can define them from the same list
+
+#define HOST_NOTIFICATION_MESSAGES(X) \
+    X(vibro_on) \
+    X(vibro_off) \
+    X(sound_off) \
+    X(display_backlight_on) \
+    X(display_backlight_off) \
+    X(red_255) \
+    X(green_255) \
+    X(blue_255) \
+    X(red_0) \
+    X(green_0) \
+    X(blue_0) \
+    X(delay_1) \
+    X(delay_10) \
+    X(delay_25) \
+    X(delay_50) \
+    X(delay_100) \
+    X(delay_250) \
+    X(delay_500) \
+    X(delay_1000) \
+    X(do_not_disturb) \
+    X(force_speaker_volume_setting_1f) \
+    X(force_vibro_setting_on) \
+    X(force_display_brightness_setting_1f) \
+    X(note_c0) \
+    X(note_cs0) \
+    X(note_d0) \
+    X(note_ds0) \
+    X(note_e0) \
+    X(note_f0) \
+    X(note_fs0) \
+    X(note_g0) \
+    X(note_gs0) \
+    X(note_a0) \
+    X(note_as0) \
+    X(note_b0) \
+    X(note_c1) \
+    X(note_cs1) \
+    X(note_d1) \
+    X(note_ds1) \
+    X(note_e1) \
+    X(note_f1) \
+    X(note_fs1) \
+    X(note_g1) \
+    X(note_gs1) \
+    X(note_a1) \
+    X(note_as1) \
+    X(note_b1) \
+    X(note_c2) \
+    X(note_cs2) \
+    X(note_d2) \
+    X(note_ds2) \
+    X(note_e2) \
+    X(note_f2) \
+    X(note_fs2) \
+    X(note_g2) \
+    X(note_gs2) \
+    X(note_a2) \
+    X(note_as2) \
+    X(note_b2) \
+    X(note_c3) \
+    X(note_cs3) \
+    X(note_d3) \
+    X(note_ds3) \
+    X(note_e3) \
+    X(note_f3) \
+    X(note_fs3) \
+    X(note_g3) \
+    X(note_gs3) \
+    X(note_a3) \
+    X(note_as3) \
+    X(note_b3) \
+    X(note_c4) \
+    X(note_cs4) \
+    X(note_d4) \
+    X(note_ds4) \
+    X(note_e4) \
+    X(note_f4) \
+    X(note_fs4) \
+    X(note_g4) \
+    X(note_gs4) \
+    X(note_a4) \
+    X(note_as4) \
+    X(note_b4) \
+    X(note_c5) \
+    X(note_cs5) \
+    X(note_d5) \
+    X(note_ds5) \
+    X(note_e5) \
+    X(note_f5) \
+    X(note_fs5) \
+    X(note_g5) \
+    X(note_gs5) \
+    X(note_a5) \
+    X(note_as5) \
+    X(note_b5) \
+    X(note_c6) \
+    X(note_cs6) \
+    X(note_d6) \
+    X(note_ds6) \
+    X(note_e6) \
+    X(note_f6) \
+    X(note_fs6) \
+    X(note_g6) \
+    X(note_gs6) \
+    X(note_a6) \
+    X(note_as6) \
+    X(note_b6) \
+    X(note_c7) \
+    X(note_cs7) \
+    X(note_d7) \
+    X(note_ds7) \
+    X(note_e7) \
+    X(note_f7) \
+    X(note_fs7) \
+    X(note_g7) \
+    X(note_gs7) \
+    X(note_a7) \
+    X(note_as7) \
+    X(note_b7) \
+    X(note_c8) \
+    X(note_cs8) \
+    X(note_d8) \
+    X(note_ds8) \
+    X(note_e8) \
+    X(note_f8) \
+    X(note_fs8) \
+    X(note_g8) \
+    X(note_gs8) \
+    X(note_a8) \
+    X(note_as8) \
+    X(note_b8)
+
+#define HOST_NOTIFICATION_EXTERN(name) extern const NotificationMessage message_##name;
+HOST_NOTIFICATION_MESSAGES(HOST_NOTIFICATION_EXTERN)
+#undef HOST_NOTIFICATION_EXTERN
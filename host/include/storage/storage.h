@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// the slice of the firmware storage api the apps use. host paths under /ext
+// map onto a local directory, see HostSimConfig.storage_root.
+
+#define RECORD_STORAGE "storage"
+
+#define STORAGE_EXT_PATH_PREFIX "/ext"
+#define EXT_PATH(path) STORAGE_EXT_PATH_PREFIX "/" path
+
+typedef enum {
+    FSAM_READ = (1 << 0),
+    FSAM_WRITE = (1 << 1),
+    FSAM_READ_WRITE = FSAM_READ | FSAM_WRITE,
+} FS_AccessMode;
+
+typedef enum {
+    FSOM_OPEN_EXISTING = 1,
+    FSOM_OPEN_ALWAYS = 2,
+    FSOM_OPEN_APPEND = 4,
+    FSOM_CREATE_NEW = 8,
+    FSOM_CREATE_ALWAYS = 16,
+} FS_OpenMode;
+
+typedef struct Storage Storage;
+typedef struct File File;
+
+File* storage_file_alloc(Storage* storage);
+void storage_file_free(File* file);
+bool storage_file_open(File* file, const char* path, FS_AccessMode access_mode, FS_OpenMode open_mode);
+bool storage_file_close(File* file);
+bool storage_file_is_open(File* file);
+uint16_t storage_file_read(File* file, void* buff, uint16_t bytes_to_read);
+uint16_t storage_file_write(File* file, const void* buff, uint16_t bytes_to_write);
+bool storage_file_seek(File* file, uint32_t offset, bool from_start);
+uint64_t storage_file_size(File* file);
+// true if the directory exists afterwards, parent has to exist already
+bool storage_simply_mkdir(Storage* storage, const char* path);
@@ -0,0 +1,30 @@
+#include <furi.h>
+#include <notification/notification.h>
+#include <notification/notification_messages.h>
+
+#include "host_sim.h"
+
+// notifications are only counted, there's no speaker or vibro on a ci box
+
+struct NotificationApp {
+    const NotificationSequence* last;
+};
+
+static NotificationApp notification_app;
+
+#define HOST_NOTIFICATION_DEFINE(name) const NotificationMessage message_##name = {#name};
+HOST_NOTIFICATION_MESSAGES(HOST_NOTIFICATION_DEFINE)
+#undef HOST_NOTIFICATION_DEFINE
+
+NotificationApp* host_notification_record(void) {
+    return &notification_app;
+}
+
+void notification_message(NotificationApp* app, const NotificationSequence* sequence) {
+    app->last = sequence;
+    host_sim_stats()->notifications++;
+}
+
+void notification_message_block(NotificationApp* app, const NotificationSequence* sequence) {
+    notification_message(app, sequence);
+}
@@ -0,0 +1,287 @@
+#include <furi.h>
+
+#include <getopt.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "host_sim.h"
+
+// runs one app's real entry point headless. built once per app, the
+// Makefile sets HOST_APP_ENTRY / HOST_APP_NAME.
+
+#ifndef HOST_APP_ENTRY
+#error "HOST_APP_ENTRY must name the app entry point"
+#endif
+
+// the Makefile points this at build/ext, where it stages app data files
+#ifndef HOST_STORAGE_ROOT
+#define HOST_STORAGE_ROOT "ext"
+#endif
+
+int32_t HOST_APP_ENTRY(void* p);
+
+typedef struct {
+    const char* dump_dir;
+    uint8_t last_frame[HOST_FB_SIZE];
+    // --hashes, every frame's hash goes here
+    FILE* hashes;
+    // --check, the golden hash of every frame and how many didn't match
+    uint64_t* golden;
+    size_t golden_len;
+    uint64_t mismatches;
+    uint64_t first_mismatch;
+    // where frames that don't match go, and the golden build's frames to
+    // diff them with
+    const char* diff_dir;
+    const char* reference_dir;
+} FrameSink;
+
+static void write_frame(const uint8_t* framebuffer, const char* dir, uint64_t frame, const char* suffix) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frame_%06llu%s.pbm", dir, (unsigned long long)frame, suffix);
+    FILE* out = fopen(path, "wb");
+    if(out) {
+        host_fb_write_pbm(framebuffer, out);
+        fclose(out);
+    }
+}
+
+// a frame that doesn't match its golden hash: write it out, and if the
+// golden build's frame is around, the pixels that changed (black)
+static void write_mismatch(const FrameSink* sink, const uint8_t* framebuffer, uint64_t frame) {
+    write_frame(framebuffer, sink->diff_dir, frame, "");
+    if(!sink->reference_dir) return;
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frame_%06llu.pbm", sink->reference_dir, (unsigned long long)frame);
+    FILE* in = fopen(path, "rb");
+    uint8_t diff[HOST_FB_SIZE];
+    bool ok = in && host_fb_read_pbm(diff, in);
+    if(in) fclose(in);
+    if(!ok) return;
+    for(size_t i = 0; i < HOST_FB_SIZE; i++) {
+        diff[i] ^= framebuffer[i];
+    }
+    write_frame(diff, sink->diff_dir, frame, "_diff");
+}
+
+static void on_frame(const uint8_t* framebuffer, uint64_t frame, void* context) {
+    FrameSink* sink = context;
+    memcpy(sink->last_frame, framebuffer, HOST_FB_SIZE);
+    if(sink->dump_dir) {
+        write_frame(framebuffer, sink->dump_dir, frame, "");
+    }
+    if(!sink->hashes && !sink->golden) return;
+    uint64_t hash = host_fb_hash(framebuffer);
+    if(sink->hashes) {
+        fprintf(sink->hashes, "%06llu %016llx\n", (unsigned long long)frame, (unsigned long long)hash);
+    }
+    if(sink->golden && (frame >= sink->golden_len || sink->golden[frame] != hash)) {
+        if(!sink->mismatches++) sink->first_mismatch = frame;
+        if(sink->diff_dir) write_mismatch(sink, framebuffer, frame);
+    }
+}
+
+// a file --hashes wrote, one "<frame> <hash>" line per frame, in order.
+// '#' starts a comment
+static bool load_golden(const char* path, uint64_t** hashes, size_t* count) {
+    FILE* file = fopen(path, "r");
+    if(!file) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    size_t capacity = 256;
+    *hashes = malloc(capacity * sizeof(uint64_t));
+    *count = 0;
+    char line[128];
+    for(unsigned line_no = 1; fgets(line, sizeof(line), file); line_no++) {
+        char* comment = strchr(line, '#');
+        if(comment) *comment = '\0';
+        unsigned long long frame, hash;
+        int fields = sscanf(line, "%llu %llx", &frame, &hash);
+        if(fields <= 0) continue;
+        if(fields != 2 || frame != *count) {
+            fprintf(stderr, "%s:%u: expected '%06zu <hash>'\n", path, line_no, *count);
+            fclose(file);
+            free(*hashes);
+            return false;
+        }
+        if(*count == capacity) {
+            capacity *= 2;
+            *hashes = realloc(*hashes, capacity * sizeof(uint64_t));
+        }
+        (*hashes)[(*count)++] = hash;
+    }
+    fclose(file);
+    return true;
+}
+
+static void usage(const char* prog) {
+    fprintf(
+        stderr,
+        "usage: %s [options]\n"
+        "  -s, --script FILE     scripted input, see host_sim.h for the format\n"
+        "  -d, --duration MS     virtual run time before back is pressed (default 10000)\n"
+        "  -r, --seed N          seed for furi_hal_random_get (default 1)\n"
+        "  -n, --no-render       skip draw callbacks, logic only\n"
+        "  -o, --dump DIR        write every frame to DIR as pbm\n"
+        "  -a, --ascii           print the last frame as ascii art\n"
+        "  -l, --log LEVEL       furi log level 0..5 (default 2, warnings)\n"
+        "  -S, --storage DIR     directory standing in for the sd card (default %s)\n"
+        "  -A, --args ARGS       the app's launch args, e.g. \"record\" or \"replay /ext/j 100\"\n"
+        "  -H, --hashes FILE     write every frame's hash to FILE, a golden file\n"
+        "  -c, --check FILE      compare every frame's hash to golden FILE, exit 2 if any differ\n"
+        "  -D, --diff DIR        with --check, write frames that differ to DIR as pbm\n"
+        "  -R, --reference DIR   --dump of the build that made the golden file, with\n"
+        "                        --diff also writes which pixels changed\n",
+        prog,
+        HOST_STORAGE_ROOT);
+}
+
+int main(int argc, char** argv) {
+    static const struct option options[] = {
+        {"script", required_argument, NULL, 's'},
+        {"duration", required_argument, NULL, 'd'},
+        {"seed", required_argument, NULL, 'r'},
+        {"no-render", no_argument, NULL, 'n'},
+        {"dump", required_argument, NULL, 'o'},
+        {"ascii", no_argument, NULL, 'a'},
+        {"log", required_argument, NULL, 'l'},
+        {"storage", required_argument, NULL, 'S'},
+        {"args", required_argument, NULL, 'A'},
+        {"hashes", required_argument, NULL, 'H'},
+        {"check", required_argument, NULL, 'c'},
+        {"diff", required_argument, NULL, 'D'},
+        {"reference", required_argument, NULL, 'R'},
+        {"help", no_argument, NULL, 'h'},
+        {0},
+    };
+
+    HostSimConfig config = {
+        .seed = 1,
+        .duration_ms = 10000,
+        .render = true,
+        .log_level = FuriLogLevelWarn,
+        .storage_root = HOST_STORAGE_ROOT,
+    };
+    static FrameSink sink;
+    const char* script_path = NULL;
+    bool ascii = false;
+    char* app_args = NULL;
+    const char* golden_path = NULL;
+
+    for(int opt; (opt = getopt_long(argc, argv, "s:d:r:no:al:S:A:H:c:D:R:h", options, NULL)) != -1;) {
+        switch(opt) {
+        case 's':
+            script_path = optarg;
+            break;
+        case 'd':
+            config.duration_ms = strtoul(optarg, NULL, 10);
+            break;
+        case 'r':
+            config.seed = strtoul(optarg, NULL, 0);
+            break;
+        case 'n':
+            config.render = false;
+            break;
+        case 'o':
+            sink.dump_dir = optarg;
+            mkdir(optarg, 0755);
+            break;
+        case 'a':
+            ascii = true;
+            break;
+        case 'l':
+            config.log_level = atoi(optarg);
+            break;
+        case 'S':
+            config.storage_root = optarg;
+            break;
+        case 'A':
+            app_args = optarg;
+            break;
+        case 'H':
+            sink.hashes = fopen(optarg, "w");
+            if(!sink.hashes) {
+                fprintf(stderr, "%s: cannot create\n", optarg);
+                return 1;
+            }
+            break;
+        case 'c':
+            golden_path = optarg;
+            break;
+        case 'D':
+            sink.diff_dir = optarg;
+            mkdir(optarg, 0755);
+            break;
+        case 'R':
+            sink.reference_dir = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    HostScriptEvent* script = NULL;
+    if(script_path) {
+        if(!host_script_load(script_path, &script, &config.script_len, &config.duration_ms)) {
+            return 1;
+        }
+        config.script = script;
+    }
+    if(golden_path && !load_golden(golden_path, &sink.golden, &sink.golden_len)) {
+        return 1;
+    }
+    config.on_frame = on_frame;
+    config.on_frame_context = &sink;
+    host_sim_init(&config);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int32_t ret = HOST_APP_ENTRY(app_args);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double wall = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    const HostSimStats* stats = host_sim_stats();
+    if(ascii) {
+        host_fb_print(sink.last_frame, stdout);
+    }
+    printf(
+        "app=%s ret=%d sim_ms=%u ticks=%llu frames=%llu inputs=%llu notifications=%llu "
+        "queue_drops=%llu wall_s=%.6f ticks_per_s=%.0f\n",
+        HOST_APP_NAME,
+        (int)ret,
+        stats->now_ms,
+        (unsigned long long)stats->ticks,
+        (unsigned long long)stats->frames,
+        (unsigned long long)stats->inputs,
+        (unsigned long long)stats->notifications,
+        (unsigned long long)stats->queue_drops,
+        wall,
+        wall > 0 ? stats->ticks / wall : 0.0);
+
+    if(sink.hashes) {
+        fclose(sink.hashes);
+    }
+    if(sink.golden) {
+        // a run that stops short of the golden one differs too
+        if(stats->frames < sink.golden_len && !sink.mismatches++) {
+            sink.first_mismatch = stats->frames;
+        }
+        if(sink.mismatches) {
+            fprintf(
+                stderr,
+                "%s: %llu of %llu frames differ from %s (%zu golden), first at frame %llu\n",
+                HOST_APP_NAME,
+                (unsigned long long)sink.mismatches,
+                (unsigned long long)stats->frames,
+                golden_path,
+                sink.golden_len,
+                (unsigned long long)sink.first_mismatch);
+            ret = 2;
+        }
+        free(sink.golden);
+    }
+    free(script);
+    return ret;
+}
@@ -0,0 +1,124 @@
+#include <furi.h>
+#include <storage/storage.h>
+
+#include <errno.h>
+#include <sys/stat.h>
+
+#include "host_sim.h"
+
+// files under /ext are plain files under HostSimConfig.storage_root. no
+// root configured means no sd card: every open fails, like on a device
+// without one.
+
+struct Storage {
+    uint8_t unused;
+};
+
+struct File {
+    FILE* fp;
+};
+
+static Storage storage;
+
+Storage* host_storage_record(void) {
+    return &storage;
+}
+
+File* storage_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    File* file = malloc(sizeof(File));
+    file->fp = NULL;
+    return file;
+}
+
+void storage_file_free(File* file) {
+    if(file->fp) {
+        fclose(file->fp);
+    }
+    free(file);
+}
+
+// where an /ext path lives on the host, false for anything else
+static bool host_storage_path(const char* path, char* host_path, size_t size) {
+    const char* root = host_sim_config()->storage_root;
+    const size_t prefix_len = strlen(STORAGE_EXT_PATH_PREFIX);
+    if(!root || strncmp(path, STORAGE_EXT_PATH_PREFIX, prefix_len) || (path[prefix_len] && path[prefix_len] != '/')) {
+        return false;
+    }
+    snprintf(host_path, size, "%s%s", root, path + prefix_len);
+    return true;
+}
+
+bool storage_file_open(File* file, const char* path, FS_AccessMode access_mode, FS_OpenMode open_mode) {
+    char host_path[512];
+    if(!host_storage_path(path, host_path, sizeof(host_path))) return false;
+
+    const char* mode;
+    if(open_mode & (FSOM_CREATE_ALWAYS | FSOM_CREATE_NEW)) {
+        if(open_mode & FSOM_CREATE_NEW) {
+            FILE* existing = fopen(host_path, "rb");
+            if(existing) {
+                fclose(existing);
+                return false;
+            }
+        }
+        mode = (access_mode & FSAM_READ) ? "w+b" : "wb";
+    } else if(open_mode & FSOM_OPEN_APPEND) {
+        mode = (access_mode & FSAM_READ) ? "a+b" : "ab";
+    } else if(access_mode & FSAM_WRITE) {
+        mode = "r+b";
+    } else {
+        mode = "rb";
+    }
+    file->fp = fopen(host_path, mode);
+    if(!file->fp && (open_mode & FSOM_OPEN_ALWAYS)) {
+        file->fp = fopen(host_path, (access_mode & FSAM_READ) ? "w+b" : "wb");
+    }
+    if(!file->fp) {
+        FURI_LOG_D("host", "storage: can't open %s: %s", host_path, strerror(errno));
+    }
+    return file->fp != NULL;
+}
+
+bool storage_file_close(File* file) {
+    if(!file->fp) return false;
+    fclose(file->fp);
+    file->fp = NULL;
+    return true;
+}
+
+bool storage_file_is_open(File* file) {
+    return file->fp != NULL;
+}
+
+uint16_t storage_file_read(File* file, void* buff, uint16_t bytes_to_read) {
+    if(!file->fp) return 0;
+    return fread(buff, 1, bytes_to_read, file->fp);
+}
+
+uint16_t storage_file_write(File* file, const void* buff, uint16_t bytes_to_write) {
+    if(!file->fp) return 0;
+    return fwrite(buff, 1, bytes_to_write, file->fp);
+}
+
+bool storage_file_seek(File* file, uint32_t offset, bool from_start) {
+    if(!file->fp) return false;
+    return fseek(file->fp, offset, from_start ? SEEK_SET : SEEK_CUR) == 0;
+}
+
+uint64_t storage_file_size(File* file) {
+    if(!file->fp) return 0;
+    long pos = ftell(file->fp);
+    fseek(file->fp, 0, SEEK_END);
+    long size = ftell(file->fp);
+    fseek(file->fp, pos, SEEK_SET);
+    return size;
+}
+
+bool storage_simply_mkdir(Storage* storage, const char* path) {
+    UNUSED(storage);
+    char host_path[512];
+    if(!host_storage_path(path, host_path, sizeof(host_path))) return false;
+    // like the firmware, a directory that's already there is fine
+    return mkdir(host_path, 0755) == 0 || errno == EEXIST;
+}
@@ -0,0 +1,71 @@
+#include "../../walk_guy/tilemap.h"
+#include "../host_sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// tilemap loading against a map file written here: every tile id a chunk
+// can hold, 0..15, has to come back as one the game has tables for
+
+#define TEST_MAP_TILES 16
+
+static int failures;
+
+static void expect_tile(const Tilemap* map, int16_t tx, int16_t ty, uint8_t want) {
+    uint8_t got = tilemap_get(map, tx, ty);
+    if(got != want) {
+        fprintf(stderr, "tile %d,%d: got %u, want %u\n", tx, ty, got, want);
+        failures++;
+    }
+}
+
+// one chunk, 16x16 tiles, tile i of it is id i % 16
+static bool write_map(const char* path) {
+    uint8_t header[TILEMAP_HEADER_SIZE] = {'W', 'G', 'M', 'P', TILEMAP_VERSION, TEST_MAP_TILES, TEST_MAP_TILES, 0, TEST_MAP_TILES};
+    uint8_t tiles[TEST_MAP_TILES * TEST_MAP_TILES / 2];
+    for(uint16_t i = 0; i < sizeof(tiles); i++) {
+        tiles[i] = ((i * 2) % 16) | (((i * 2 + 1) % 16) << 4);
+    }
+    FILE* fp = fopen(path, "wb");
+    if(!fp) return false;
+    bool ok = fwrite(header, sizeof(header), 1, fp) == 1 && fwrite(tiles, sizeof(tiles), 1, fp) == 1;
+    return !fclose(fp) && ok;
+}
+
+int main(void) {
+    char root[] = "/tmp/test_tilemap_XXXXXX";
+    if(!mkdtemp(root)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    char path[sizeof(root) + 16];
+    snprintf(path, sizeof(path), "%s/test.map", root);
+    if(!write_map(path)) {
+        perror(path);
+        return 1;
+    }
+    HostSimConfig config = {.seed = 1, .log_level = FuriLogLevelError, .storage_root = root};
+    host_sim_init(&config);
+
+    Tilemap* map = tilemap_alloc(EXT_PATH("test.map"));
+    if(!map->file || map->width != TEST_MAP_TILES || map->height != TEST_MAP_TILES) {
+        fprintf(stderr, "test.map didn't load\n");
+        failures++;
+    }
+    tilemap_stream(map, 0, 0, TEST_MAP_TILES * TILE_W, TEST_MAP_TILES * TILE_H);
+    for(int16_t ty = 0; ty < TEST_MAP_TILES; ty++) {
+        for(int16_t tx = 0; tx < TEST_MAP_TILES; tx++) {
+            uint8_t id = (ty * TEST_MAP_TILES + tx) % 16;
+            expect_tile(map, tx, ty, id < TILE_COUNT ? id : TILE_OUTSIDE);
+        }
+    }
+    // id 15 is the last tile of every row
+    expect_tile(map, TEST_MAP_TILES - 1, 0, TILE_OUTSIDE);
+    tilemap_free(map);
+
+    remove(path);
+    rmdir(root);
+    printf("test_tilemap: %s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
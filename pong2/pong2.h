@@ -1,7 +1,6 @@
 #pragma once
 
 #include <furi.h>
-#include <furi_hal_random.h>
 #include <gui/gui.h>
 #include <input/input.h>
 #include <notification/notification.h>
@@ -10,97 +9,52 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
+#include "../common/game_runtime.h"
+#include "../common/game_sounds.h"
+#include "pong_court.h"
+#include "pong_ai.h"
+
 #define DEBUG_TEXT 1
 
-#define PADDLE_W 2
-#define PADDLE_H 12
-#define BALL_W 2
-#define SCREEN_WIDTH 126
-#define SCREEN_HEIGHT 62
-#define CPU_X 5
-#define PLAYER_X 122
-#define PLAYER_SCORE_X 115
-#define CPU_SCORE_X 15
-#define SCORE_Y 10
-
-
-// 0= clock tick 1= key press
-typedef enum {
-    EventTypeTick,
-    EventTypeKey,
-} EventType;
-
-// struct to hold events, to be put in event queue
+// game logic rate and how often we ask for a redraw. logic runs at exactly
+// LOGIC_HZ no matter how fast frames come, drawing interpolates in between.
+#define LOGIC_HZ 4
+#define FRAME_HZ 60
+
+// every ball in play, one array per field (structure of arrays) so the
+// per step loops over them stream through memory. balls 0..count-1 are
+// live, there's always at least one.
 typedef struct {
-    EventType type;
-    InputEvent input;
-} PluginEvent;
+    fixed_t x[BALL_CAPACITY];
+    fixed_t y[BALL_CAPACITY];
+    fixed_t xspeed[BALL_CAPACITY];
+    fixed_t yspeed[BALL_CAPACITY];
+    // where they were before the last logic step, for interpolation
+    fixed_t prev_x[BALL_CAPACITY];
+    fixed_t prev_y[BALL_CAPACITY];
+    uint8_t count;
+} Balls;
 
-// mutex to hold global states one might want to fuck with
+// global states one might want to fuck with. owned by the game loop, the
+// gui only ever sees snapshots of it
 typedef struct {
-    uint8_t ball_x, ball_y;
-    int8_t ball_xspeed, ball_yspeed;
-    float ball_slope, actual_y;
+    Balls balls;
+    // each paddle's top (or left) end, see paddle_specs, and where it was
+    // before the last logic step for interpolation
+    uint8_t paddle_pos[PaddleCount];
+    uint8_t prev_paddle_pos[PaddleCount];
+    // how far into the next logic step this frame is, 0..255
+    uint8_t render_alpha;
     uint8_t cpu_score, player_score;
-    uint8_t cpu_y, player_y;
-    uint8_t player_speed, cpu_speed;
+    uint8_t player_speed;
+    PongAi ai;
 
     bool is_muted;
+    bool is_paused;
 
 } PluginState;
 
-const NotificationSequence sequence_player_score = {
-    &message_vibro_on,
-    &message_green_255,
-    &message_note_c4,
-    &message_delay_50,
-    &message_note_e4,
-    &message_delay_50,
-    &message_blue_255,
-    &message_note_g5,
-    &message_delay_50,
-    &message_note_a5,
-    &message_delay_100,
-    &message_note_c6,
-    &message_delay_100,
-    &message_sound_off,
-    &message_vibro_off,
-    &message_green_0,
-    &message_blue_0,
-    NULL,
-};
-
-const NotificationSequence sequence_cpu_score = {
-    &message_vibro_on,
-    &message_green_255,
-    &message_note_ds4,
-    &message_delay_50,
-    &message_note_d4,
-    &message_delay_50,
-    &message_red_255,
-    &message_note_a2,
-    &message_delay_250,
-    &message_sound_off,
-    &message_vibro_off,
-    &message_green_0,
-    &message_blue_0,
-    NULL,
-};
-
-const NotificationSequence sequence_blip = {
-    &message_vibro_on,
-    &message_note_ds4,
-    &message_delay_10,
-    &message_note_f4,
-    &message_delay_10,
-    &message_note_g4,
-    &message_delay_10,
-    &message_sound_off,
-    &message_vibro_off,
-    NULL,
-};
-
-static void draw_all(PluginState* const plugin_state, Canvas* const canvas) {
+static void draw_all(const PluginState* const plugin_state, Canvas* const canvas) {
     // draw the scores
     char buf_c[6];
     char buf_p[6];
@@ -111,164 +65,325 @@ static void draw_all(PluginState* const plugin_state, Canvas* const canvas) {
 
     // put any debug text to be seen here
     if(DEBUG_TEXT) {
-        char x_buf[6];
-        char y_buf[6];
-        snprintf(x_buf, sizeof(x_buf), "%.2f", plugin_state->actual_y);
-        snprintf(y_buf, sizeof(y_buf), "%d", plugin_state->ball_y);
+        char x_buf[12];
+        char y_buf[12];
+        // the first ball, sub-pixel as int.hundredths, keeps float printf
+        // out of the binary
+        fixed_t x = plugin_state->balls.x[0];
+        fixed_t y = plugin_state->balls.y[0];
+        snprintf(x_buf, sizeof(x_buf), "%d.%02d", FIXED_TO_INT(x), (int)(((x & (FIXED_ONE - 1)) * 100) >> FIXED_SHIFT));
+        snprintf(y_buf, sizeof(y_buf), "%d.%02d", FIXED_TO_INT(y), (int)(((y & (FIXED_ONE - 1)) * 100) >> FIXED_SHIFT));
         canvas_draw_str_aligned(canvas, 30, 20, AlignRight, AlignBottom, x_buf);
-        canvas_draw_str_aligned(canvas, 50, 20, AlignRight, AlignBottom, y_buf);
+        canvas_draw_str_aligned(canvas, 56, 20, AlignRight, AlignBottom, y_buf);
     }
 
-    // draw the paddles
-    canvas_draw_box(canvas, CPU_X, plugin_state->cpu_y, PADDLE_W, PADDLE_H);
-    canvas_draw_box(canvas, PLAYER_X, plugin_state->player_y, PADDLE_W, PADDLE_H);
+    // draw the paddles. the player paddle moves on input, not on logic
+    // steps, move_player keeps its prev in step so it doesn't lag
+    uint8_t alpha = plugin_state->render_alpha;
+    for(uint8_t p = 0; p < PaddleCount; p++) {
+        const PaddleSpec* spec = &paddle_specs[p];
+        int16_t pos = fixed_step_lerp(plugin_state->prev_paddle_pos[p], plugin_state->paddle_pos[p], alpha);
+        if(spec->axis == PongAxisX) {
+            canvas_draw_box(canvas, spec->line, pos, PADDLE_W, PADDLE_H);
+        } else {
+            canvas_draw_box(canvas, pos, spec->line, PADDLE_H, PADDLE_W);
+        }
+    }
+
+    if(plugin_state->is_paused) {
+        canvas_draw_str_aligned(canvas, 64, 32, AlignCenter, AlignCenter, "paused");
+    }
+
+    //draw the balls
+    const Balls* balls = &plugin_state->balls;
+    for(uint8_t i = 0; i < balls->count; i++) {
+        fixed_t ball_x = fixed_step_lerp(balls->prev_x[i], balls->x[i], alpha);
+        fixed_t ball_y = fixed_step_lerp(balls->prev_y[i], balls->y[i], alpha);
+        canvas_draw_box(canvas, FIXED_TO_INT(ball_x), FIXED_TO_INT(ball_y), BALL_W, BALL_W);
+    }
+}
 
-    //draw the ball
-    canvas_draw_box(canvas, plugin_state->ball_x, plugin_state->ball_y, BALL_W, BALL_W);
+// serve a ball from the middle, and tell the cpu
+static void reset_ball(PluginState* const plugin_state, uint8_t ball) {
+    Balls* balls = &plugin_state->balls;
+    balls->x[ball] = INT_TO_FIXED(64);
+    balls->y[ball] = INT_TO_FIXED(32);
+    // anywhere from 2 to 5 px per tick, sub-pixel included
+    balls->xspeed[ball] = INT_TO_FIXED(2) + (fixed_t)(game_random_get() % INT_TO_FIXED(5 - 2));
+    balls->yspeed[ball] = INT_TO_FIXED(2) + (fixed_t)(game_random_get() % INT_TO_FIXED(5 - 2));
+    uint8_t xr = (uint8_t)(game_random_get() % 2);
+    uint8_t yr = (uint8_t)(game_random_get() % 2);
+    if(xr) balls->xspeed[ball] *= -1;
+    if(yr) balls->yspeed[ball] *= -1;
+    // new ball, nothing to interpolate from
+    balls->prev_x[ball] = balls->x[ball];
+    balls->prev_y[ball] = balls->y[ball];
+    pong_ai_course(&plugin_state->ai, ball, balls->x[ball], balls->y[ball], balls->xspeed[ball], balls->yspeed[ball]);
 }
 
-static void reset_ball(PluginState* const plugin_state) {
-    plugin_state->ball_x = 64;
-    plugin_state->ball_y = 32;
-    plugin_state->ball_xspeed = (uint8_t)((furi_hal_random_get() % (5 - 2 + 1)) + 2);
-    plugin_state->ball_yspeed = (uint8_t)((furi_hal_random_get() % (5 - 2 + 1)) + 2);
-    uint8_t xr = (uint8_t)(furi_hal_random_get() % 2);
-    uint8_t yr = (uint8_t)(furi_hal_random_get() % 2);
-    if(xr) plugin_state->ball_xspeed *= -1;
-    if(yr) plugin_state->ball_yspeed *= -1;
-    
+// put another ball in play, the stress mode. false when they're all out
+static bool add_ball(PluginState* const plugin_state) {
+    Balls* balls = &plugin_state->balls;
+    if(balls->count >= BALL_CAPACITY) return false;
+    reset_ball(plugin_state, balls->count++);
+    pong_ai_choose(&plugin_state->ai, balls->count);
+    return true;
 }
 
 // pass plugin state pointer to have its x,y set to default
 static void pong_state_init(PluginState* const plugin_state) {
     plugin_state->is_muted = false;
-    reset_ball(plugin_state);
-    plugin_state->cpu_y = 32 - (PADDLE_H / 2);
-    plugin_state->player_y = 32 - (PADDLE_H / 2);
+    plugin_state->is_paused = false;
+    pong_ai_init(&plugin_state->ai, PONG_AI_LEVEL);
+    // unused ball slots too, so snapshots compare the same
+    memset(&plugin_state->balls, 0, sizeof(Balls));
+    add_ball(plugin_state);
+    for(uint8_t p = 0; p < PaddleCount; p++) {
+        plugin_state->paddle_pos[p] = 32 - (PADDLE_H / 2);
+        plugin_state->prev_paddle_pos[p] = plugin_state->paddle_pos[p];
+    }
+    plugin_state->render_alpha = 0;
     plugin_state->cpu_score = 0;
     plugin_state->player_score = 0;
-    plugin_state->player_speed = 4;
-    plugin_state->cpu_speed = 4;
+    // px per frame while up/down is held
+    plugin_state->player_speed = 1;
 }
 
 
-static void process_step(PluginState* const plugin_state, NotificationApp* notify) {
+// time until pos moving at speed reaches plane, in fractions of a tick.
+// only called once we know the plane is crossed within 'remaining'.
+static inline fixed_t time_to_plane(fixed_t pos, fixed_t speed, fixed_t plane) {
+    return fixed_div(plane - pos, speed);
+}
 
-    // ball wall collision checking
-    if(plugin_state->ball_y >= SCREEN_HEIGHT || plugin_state->ball_y <= 2) {
-        if(!plugin_state->is_muted) {
-            notification_message(notify, &sequence_blip);
+// does the ball, at height y, overlap a paddle whose top is at paddle_y
+static inline bool ball_meets_paddle(fixed_t y, uint8_t paddle_y) {
+    return y + INT_TO_FIXED(BALL_W) > INT_TO_FIXED(paddle_y) && y < INT_TO_FIXED(paddle_y + PADDLE_H);
+}
+
+// find the first thing a ball runs into within 'remaining' of this tick.
+// returns BallHitNone if the ball gets there without touching anything,
+// otherwise sets *toi to how far into 'remaining' the hit happens, and *row
+// to the paddle_specs row for BallHitPaddle, the court_edges row for the
+// rest. two at the same time go to the paddle, then the first edge in the
+// table, so a paddle lying on a wall line gets the ball and not the wall.
+static BallHit ball_first_hit(
+    const PluginState* const plugin_state,
+    uint8_t ball,
+    fixed_t remaining,
+    fixed_t* toi,
+    uint8_t* row) {
+    const fixed_t pos[2] = {plugin_state->balls.x[ball], plugin_state->balls.y[ball]};
+    const fixed_t speed[2] = {plugin_state->balls.xspeed[ball], plugin_state->balls.yspeed[ball]};
+    const fixed_t end[2] = {pos[0] + fixed_mul(speed[0], remaining), pos[1] + fixed_mul(speed[1], remaining)};
+    BallHit hit = BallHitNone;
+    *toi = remaining;
+
+    // paddle faces, any the ball goes from in front of to behind
+    for(uint8_t p = 0; p < PaddleCount; p++) {
+        const PaddleSpec* spec = &paddle_specs[p];
+        const uint8_t along = spec->axis, across = !spec->axis;
+        const fixed_t face = INT_TO_FIXED(spec->face);
+        if((pos[along] - face) * spec->out >= 0 && (end[along] - face) * spec->out < 0) {
+            fixed_t t = time_to_plane(pos[along], speed[along], face);
+            if(t < *toi && ball_meets_paddle(pos[across] + fixed_mul(speed[across], t), plugin_state->paddle_pos[p])) {
+                *toi = t;
+                *row = p;
+                hit = BallHitPaddle;
+            }
         }
-        plugin_state->ball_yspeed *= -1;
     }
 
-    plugin_state->ball_slope = (float)(plugin_state->ball_yspeed) / (float)(plugin_state->ball_xspeed);
-
-    // player collision check
-    if((plugin_state->ball_y + BALL_W) <= (plugin_state->player_y + PADDLE_H) && plugin_state->ball_y >= plugin_state->player_y) {
-        if((plugin_state->ball_x + BALL_W + plugin_state->ball_xspeed) > PLAYER_X) {
-            // correct ball pos if necessary
-            plugin_state->actual_y = plugin_state->ball_y + ((float)(plugin_state->ball_x)/(float)(PLAYER_X + BALL_W)) * plugin_state->ball_yspeed;
-            plugin_state->ball_x = PLAYER_X - BALL_W;
-            uint8_t loc = plugin_state->ball_y - plugin_state->player_y;
-            if(loc < 2) {
-                plugin_state->ball_xspeed = -2;
-                plugin_state->ball_yspeed = -6;
-            } else if(loc >= 2 && loc < 4) {
-                plugin_state->ball_xspeed = -3;
-                plugin_state->ball_yspeed = -4;
-            } else if(loc >= 4 && loc < 8) {
-                plugin_state->ball_xspeed = -4;
-                if(plugin_state->ball_yspeed > 0) {
-                    plugin_state->ball_yspeed = -4;
-                } else {
-                    plugin_state->ball_yspeed = 4;
-                }
-            } else if(loc >= 8 && loc < 10) {
-                plugin_state->ball_xspeed = -3;
-                plugin_state->ball_yspeed = 4;
-            } else if(loc >= 10 && loc < 12) {
-                plugin_state->ball_xspeed = -2;
-                plugin_state->ball_yspeed = -6;
-            }
-            // do alert
-            if(!plugin_state->is_muted) {
-                notification_message(notify, &sequence_blip);
+    // then the walls and goal lines, the same test all the way across
+    for(uint8_t e = 0; e < COURT_EDGE_COUNT; e++) {
+        const CourtEdge* edge = &court_edges[e];
+        const fixed_t plane = INT_TO_FIXED(edge->plane);
+        if((pos[edge->axis] - plane) * edge->out >= 0 && (end[edge->axis] - plane) * edge->out < 0) {
+            fixed_t t = time_to_plane(pos[edge->axis], speed[edge->axis], plane);
+            if(t < *toi) {
+                *toi = t;
+                *row = e;
+                hit = edge->hit;
             }
         }
     }
+    if(*toi < 0) *toi = 0;
+    return hit;
+}
 
-    // cpu collision check
-    if((plugin_state->ball_y + BALL_W) <= (plugin_state->cpu_y + PADDLE_H) && plugin_state->ball_y >= plugin_state->cpu_y) {
-        if((plugin_state->ball_x + plugin_state->ball_xspeed) < CPU_X + PADDLE_W) {
-            // correct ball pos
-            plugin_state->actual_y = plugin_state->ball_y + ((float)(plugin_state->ball_x)/(float)(CPU_X + PADDLE_W)) * plugin_state->ball_yspeed;
-            plugin_state->ball_x = CPU_X + PADDLE_W;
-            uint8_t loc = plugin_state->ball_y - plugin_state->cpu_y;
-            if(loc < 2) {
-                plugin_state->ball_xspeed = 2;
-                plugin_state->ball_yspeed = -6;
-            } else if(loc >= 2 && loc < 4) {
-                plugin_state->ball_xspeed = 3;
-                plugin_state->ball_yspeed = -4;
-            } else if(loc >= 4 && loc < 8) {
-                plugin_state->ball_xspeed = 4;
-                if(plugin_state->ball_yspeed > 0) {
-                    plugin_state->ball_yspeed = -4;
-                } else {
-                    plugin_state->ball_yspeed = 4;
-                }
-            } else if(loc >= 8 && loc < 10) {
-                plugin_state->ball_xspeed = 3;
-                plugin_state->ball_yspeed = 4;
-            } else if(loc >= 10 && loc < 12) {
-                plugin_state->ball_xspeed = 2;
-                plugin_state->ball_yspeed = 6;
-            }
+// where along a paddle the ball hit, 0 at the top (or left) end
+static inline uint8_t paddle_hit_loc(fixed_t ball_pos, uint8_t paddle_pos) {
+    int16_t loc = FIXED_TO_INT(ball_pos) - paddle_pos;
+    if(loc < 0) return 0;
+    if(loc >= PADDLE_H) return PADDLE_H - 1;
+    return loc;
+}
+
+// how a ball leaves a paddle, by where on it it hit (paddle_hit_loc), in
+// px per tick. out is away from the paddle, across is along it, + toward
+// the bottom (or right) end. mirror instead sends it back along the paddle
+// the way it came, that fast
+typedef struct {
+    uint8_t out;
+    int8_t across;
+    uint8_t mirror;
+} PaddleBounce;
 
-            // do alert
-            if(!plugin_state->is_muted) {
-                notification_message(notify, &sequence_blip);
+// five speed zones down the paddle: steep off the ends, flatter toward the
+// middle, and straight back off the middle
+static const PaddleBounce paddle_bounce[PADDLE_H] = {
+    [0 ... 1] = {.out = 2, .across = -6},
+    [2 ... 3] = {.out = 3, .across = -4},
+    [4 ... 7] = {.out = 4, .mirror = 4},
+    [8 ... 9] = {.out = 3, .across = 4},
+    [10 ... 11] = {.out = 2, .across = 6},
+};
+_Static_assert(PADDLE_H == 12, "paddle_bounce has a row per px of paddle");
+
+// send a ball that just met paddle p on its way, any paddle, no branches
+static void bounce_off_paddle(PluginState* const plugin_state, uint8_t ball, uint8_t p) {
+    Balls* balls = &plugin_state->balls;
+    const PaddleSpec* spec = &paddle_specs[p];
+    const uint8_t along = spec->axis, across = !spec->axis;
+    fixed_t* pos[2] = {&balls->x[ball], &balls->y[ball]};
+    fixed_t* speed[2] = {&balls->xspeed[ball], &balls->yspeed[ball]};
+    // snap onto the face so rounding can't leave the ball inside the paddle
+    *pos[along] = INT_TO_FIXED(spec->face);
+    const PaddleBounce* bounce = &paddle_bounce[paddle_hit_loc(*pos[across], plugin_state->paddle_pos[p])];
+    *speed[along] = INT_TO_FIXED(spec->out * bounce->out);
+    *speed[across] = INT_TO_FIXED(bounce->across - bounce->mirror * ((*speed[across] > 0) * 2 - 1));
+}
+
+// paused is the only time nothing moves on its own
+static bool pong_is_idle(const PluginState* const plugin_state) {
+    return plugin_state->is_paused;
+}
+
+// move the player paddle while up or down is held. runs every frame, not
+// every logic step, so the paddle answers input right away.
+static void move_player(PluginState* const plugin_state, uint32_t keys) {
+    uint8_t* paddle_y = &plugin_state->paddle_pos[PaddlePlayer];
+    if(keys & INPUT_KEY_BIT(InputKeyUp)) {
+        if(*paddle_y > 2) {
+            if(*paddle_y - plugin_state->player_speed < 2) {
+                *paddle_y = 2;
+            } else {
+                *paddle_y -= plugin_state->player_speed;
             }
         }
     }
-
-    // cpu score
-    if(plugin_state->ball_x >= SCREEN_WIDTH) {
-        plugin_state->cpu_score += 1;
-        if(!plugin_state->is_muted) {
-            notification_message(notify, &sequence_cpu_score);
+    if(keys & INPUT_KEY_BIT(InputKeyDown)) {
+        if((*paddle_y + PADDLE_H) < SCREEN_HEIGHT) {
+            if((*paddle_y + PADDLE_H + plugin_state->player_speed) > SCREEN_HEIGHT) {
+                *paddle_y = SCREEN_HEIGHT - PADDLE_H;
+            } else {
+                *paddle_y += plugin_state->player_speed;
+            }
         }
-        reset_ball(plugin_state);
     }
-    // player score
-    if(plugin_state->ball_x <= 2) {
-        plugin_state->player_score += 1;
-        if(!plugin_state->is_muted) {
-            notification_message(notify, &sequence_player_score);
+    plugin_state->prev_paddle_pos[PaddlePlayer] = *paddle_y;
+}
+
+// what sweep_ball ran into, a bit per BallHit
+#define BALL_HIT_BIT(hit) (1u << (hit))
+
+// swept movement for one ball: step from hit to hit until the tick is used
+// up, so fast balls can't tunnel through paddles or get stuck in walls.
+// returns what it hit
+static uint8_t sweep_ball(PluginState* const plugin_state, uint8_t ball) {
+    Balls* balls = &plugin_state->balls;
+    uint8_t hits_seen = 0;
+    fixed_t remaining = FIXED_ONE;
+    for(uint8_t hits = 0; remaining > 0 && hits < BALL_MAX_HITS; hits++) {
+        fixed_t toi;
+        uint8_t row = 0;
+        BallHit hit = ball_first_hit(plugin_state, ball, remaining, &toi, &row);
+
+        balls->x[ball] += fixed_mul(balls->xspeed[ball], toi);
+        balls->y[ball] += fixed_mul(balls->yspeed[ball], toi);
+        remaining -= toi;
+        hits_seen |= BALL_HIT_BIT(hit);
+
+        switch(hit) {
+        case BallHitNone:
+            break;
+        case BallHitWall: {
+            // snap onto the wall so rounding can't leave the ball inside it
+            const CourtEdge* edge = &court_edges[row];
+            fixed_t* pos[2] = {&balls->x[ball], &balls->y[ball]};
+            fixed_t* speed[2] = {&balls->xspeed[ball], &balls->yspeed[ball]};
+            *pos[edge->axis] = INT_TO_FIXED(edge->plane);
+            *speed[edge->axis] *= -1;
+            break;
+        }
+        case BallHitPaddle:
+            bounce_off_paddle(plugin_state, ball, row);
+            break;
+        case BallHitGoalRight:
+            // cpu score
+            plugin_state->cpu_score += 1;
+            reset_ball(plugin_state, ball);
+            remaining = 0;
+            break;
+        case BallHitGoalLeft:
+            // player score
+            plugin_state->player_score += 1;
+            reset_ball(plugin_state, ball);
+            remaining = 0;
+            break;
+        }
+        if(hit == BallHitPaddle) {
+            // new course, the cpu has to rethink
+            pong_ai_course(
+                &plugin_state->ai, ball, balls->x[ball], balls->y[ball], balls->xspeed[ball], balls->yspeed[ball]);
         }
-        reset_ball(plugin_state);
     }
+    return hits_seen;
+}
 
-    // cpu ai
-    if((plugin_state->cpu_y + PADDLE_H/2) < (plugin_state->ball_y + BALL_W/2)) {
-        if((plugin_state->cpu_y + PADDLE_H + plugin_state->cpu_speed) > SCREEN_HEIGHT) {
-            plugin_state->cpu_y = SCREEN_HEIGHT - PADDLE_H;
-        } else {
-            plugin_state->cpu_y += plugin_state->cpu_speed;
-        }
+static void process_step(PluginState* const plugin_state, NotificationApp* notify) {
+    Balls* balls = &plugin_state->balls;
+    const uint8_t count = balls->count;
+    memcpy(balls->prev_x, balls->x, count * sizeof(fixed_t));
+    memcpy(balls->prev_y, balls->y, count * sizeof(fixed_t));
+    memcpy(plugin_state->prev_paddle_pos, plugin_state->paddle_pos, sizeof(plugin_state->paddle_pos));
+
+    // most balls go a whole tick without touching anything. move every
+    // ball the whole way in one tight loop and flag the ones whose move
+    // ended outside the free box, past some paddle face or court edge
+    // line. only those get backed up and swept properly, which ends up in
+    // the same place the sweep alone would have.
+    fixed_t lo[2], hi[2];
+    court_free_box(lo, hi);
+    uint8_t crossed[BALL_CAPACITY];
+    for(uint8_t i = 0; i < count; i++) {
+        balls->x[i] += balls->xspeed[i];
+        balls->y[i] += balls->yspeed[i];
+        crossed[i] = (balls->x[i] < lo[PongAxisX]) | (balls->x[i] > hi[PongAxisX]) | (balls->y[i] < lo[PongAxisY]) |
+                     (balls->y[i] > hi[PongAxisY]);
     }
-    if((plugin_state->cpu_y + PADDLE_H/2) > (plugin_state->ball_y + BALL_W/2)) {
-        if(plugin_state->cpu_y - plugin_state->cpu_speed < 2) {
-            plugin_state->cpu_y = 2;
-        } else {
-            plugin_state->cpu_y -= plugin_state->cpu_speed;
+    uint8_t hits_seen = 0;
+    for(uint8_t i = 0; i < count; i++) {
+        if(!crossed[i]) continue;
+        balls->x[i] -= balls->xspeed[i];
+        balls->y[i] -= balls->yspeed[i];
+        hits_seen |= sweep_ball(plugin_state, i);
+    }
+
+    // one sound per step at most, however many balls hit things
+    if(!plugin_state->is_muted) {
+        if(hits_seen & BALL_HIT_BIT(BallHitGoalRight)) {
+            notification_message(notify, &sequence_cpu_score);
+        } else if(hits_seen & BALL_HIT_BIT(BallHitGoalLeft)) {
+            notification_message(notify, &sequence_player_score);
+        } else if(hits_seen & (BALL_HIT_BIT(BallHitWall) | BALL_HIT_BIT(BallHitPaddle))) {
+            notification_message(notify, &sequence_blip);
         }
     }
 
-    // updte ball position
-    plugin_state->ball_x += plugin_state->ball_xspeed;
-    // else += distance to paddle
-    plugin_state->ball_y += plugin_state->ball_yspeed;
-    // else += d 
-}
\ No newline at end of file
+    // cpu ai, only looks at the balls again when one changed course
+    if(hits_seen & ~(BALL_HIT_BIT(BallHitNone) | BALL_HIT_BIT(BallHitWall))) {
+        pong_ai_choose(&plugin_state->ai, count);
+    }
+    pong_ai_step(&plugin_state->ai, &plugin_state->paddle_pos[PaddleCpu]);
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../common/game_random.h"
+#include "pong_court.h"
+
+// the cpu paddle. rather than chase the ball every step, it works out once
+// where a ball is going to cross its face, and when, whenever that ball's
+// course changes (a paddle hit or a serve), and caches it. the walls are
+// folded into the solve, so a wall bounce doesn't change the answer and
+// costs nothing. with several balls in play it goes for whichever gets
+// there first, picked again only when some course changed. every step
+// after that is a move toward the target.
+//
+// how good it is comes from its level: how many steps it takes to react to a
+// new course, how far off its aim can be and how fast the paddle goes.
+
+typedef enum {
+    PongAiEasy,
+    PongAiNormal,
+    PongAiHard,
+    PongAiLevelCount,
+} PongAiLevelId;
+
+typedef struct {
+    // logic steps between a new course and the paddle setting off
+    uint8_t reaction_steps;
+    // the aim is off by up to this many px either way, rolled per course
+    uint8_t error_px;
+    // px per logic step
+    uint8_t speed;
+} PongAiLevel;
+
+static const PongAiLevel pong_ai_levels[PongAiLevelCount] = {
+    [PongAiEasy] = {.reaction_steps = 3, .error_px = 12, .speed = 2},
+    [PongAiNormal] = {.reaction_steps = 1, .error_px = 8, .speed = 3},
+    [PongAiHard] = {.reaction_steps = 0, .error_px = 0, .speed = 4},
+};
+
+// define before including to pick another one
+#ifndef PONG_AI_LEVEL
+#define PONG_AI_LEVEL PongAiNormal
+#endif
+
+// where the paddle waits while the ball heads the other way
+#define PONG_AI_HOME_Y (32 - PADDLE_H / 2)
+
+// aim of a ball that's heading for the player
+#define PONG_AI_AWAY 0xFF
+
+// part of the game state
+typedef struct {
+    uint8_t level; // PongAiLevelId
+    // paddle top it's heading for
+    uint8_t target_y;
+    // steps left before it sets off
+    uint8_t wait;
+    // logic steps so far, what etas count in
+    uint16_t clock;
+    // per ball: the paddle top that meets it (PONG_AI_AWAY while it's going
+    // the other way) and the step it gets there
+    uint8_t aim[BALL_CAPACITY];
+    uint16_t eta[BALL_CAPACITY];
+} PongAi;
+
+static inline uint8_t pong_ai_clamp(int16_t paddle_y) {
+    if(paddle_y < 2) return 2;
+    if(paddle_y > SCREEN_HEIGHT - PADDLE_H) return SCREEN_HEIGHT - PADDLE_H;
+    return paddle_y;
+}
+
+// where the top of a ball at x,y moving vx,vy (vx < 0) per step crosses the
+// cpu's face. between the walls the ball's height is a triangle wave, so
+// run the straight line out to the face and fold it back between BALL_MIN_Y
+// and BALL_MAX_Y, one modulo however many bounces there are. *steps, if
+// given, gets how many logic steps off that is.
+static fixed_t pong_ai_intercept(fixed_t x, fixed_t y, fixed_t vx, fixed_t vy, fixed_t* steps) {
+    fixed_t t = fixed_div(INT_TO_FIXED(CPU_X + PADDLE_W) - x, vx);
+    if(t < 0) t = 0;
+    if(steps) *steps = t;
+    const fixed_t span = INT_TO_FIXED(BALL_MAX_Y - BALL_MIN_Y);
+    fixed_t folded = (y - INT_TO_FIXED(BALL_MIN_Y) + fixed_mul(vy, t)) % (2 * span);
+    if(folded < 0) folded += 2 * span;
+    if(folded > span) folded = 2 * span - folded;
+    return INT_TO_FIXED(BALL_MIN_Y) + folded;
+}
+
+// ball just got a new course, work out where to be for it and when.
+// pong_ai_choose picks up the result
+static void pong_ai_course(PongAi* const ai, uint8_t ball, fixed_t x, fixed_t y, fixed_t vx, fixed_t vy) {
+    if(vx >= 0) {
+        ai->aim[ball] = PONG_AI_AWAY;
+        return;
+    }
+    fixed_t steps;
+    int16_t ball_y = FIXED_TO_INT(pong_ai_intercept(x, y, vx, vy, &steps));
+    int16_t error = 0;
+    const uint8_t error_px = pong_ai_levels[ai->level].error_px;
+    if(error_px) {
+        error = (int16_t)(game_random_get() % (2 * error_px + 1)) - error_px;
+    }
+    // paddle centre on ball centre, give or take
+    ai->aim[ball] = pong_ai_clamp(ball_y + BALL_W / 2 - PADDLE_H / 2 + error);
+    ai->eta[ball] = ai->clock + FIXED_TO_INT(steps);
+}
+
+// go for the first of balls 0..count-1 to arrive, home if none is coming.
+// a new target takes the reaction time to set off for
+static void pong_ai_choose(PongAi* const ai, uint8_t count) {
+    uint8_t target_y = PONG_AI_HOME_Y;
+    // a ball that's already gone by wraps around to the back of the line
+    uint16_t soonest = UINT16_MAX;
+    for(uint8_t i = 0; i < count; i++) {
+        uint16_t until = ai->eta[i] - ai->clock;
+        if(ai->aim[i] != PONG_AI_AWAY && until < soonest) {
+            soonest = until;
+            target_y = ai->aim[i];
+        }
+    }
+    if(target_y != ai->target_y) {
+        ai->target_y = target_y;
+        ai->wait = pong_ai_levels[ai->level].reaction_steps;
+    }
+}
+
+static void pong_ai_init(PongAi* const ai, uint8_t level) {
+    memset(ai, 0, sizeof(PongAi));
+    ai->level = level < PongAiLevelCount ? level : PONG_AI_LEVEL;
+    ai->target_y = PONG_AI_HOME_Y;
+    memset(ai->aim, PONG_AI_AWAY, sizeof(ai->aim));
+}
+
+// one logic step of moving the paddle toward the target
+static void pong_ai_step(PongAi* const ai, uint8_t* const paddle_y) {
+    ai->clock++;
+    if(ai->wait) {
+        ai->wait--;
+        return;
+    }
+    const uint8_t speed = pong_ai_levels[ai->level].speed;
+    if(*paddle_y + speed <= ai->target_y) {
+        *paddle_y += speed;
+    } else if(*paddle_y >= ai->target_y + speed) {
+        *paddle_y -= speed;
+    } else {
+        *paddle_y = ai->target_y;
+    }
+}
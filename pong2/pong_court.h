@@ -0,0 +1,131 @@
+#pragma once
+
+#include <stdint.h>
+
+// the court: sizes, where things sit, and the fixed point everything that
+// moves is measured in
+
+#define PADDLE_W 2
+#define PADDLE_H 12
+#define BALL_W 2
+#define SCREEN_WIDTH 126
+#define SCREEN_HEIGHT 62
+#define CPU_X 5
+#define PLAYER_X 122
+#define PLAYER_SCORE_X 115
+#define CPU_SCORE_X 15
+#define SCORE_Y 10
+
+// where the ball's top left corner can go before it hits a wall or a goal
+#define BALL_MIN_Y 2
+#define BALL_MAX_Y (SCREEN_HEIGHT - BALL_W)
+#define GOAL_LEFT_X 2
+#define GOAL_RIGHT_X SCREEN_WIDTH
+// most things the ball can hit in one tick before we give up on the rest
+#define BALL_MAX_HITS 4
+// balls that can be in play at once
+#define BALL_CAPACITY 64
+
+// ball position and speed are fixed point with 8 fractional bits (q8.8).
+// stored in 32 bits so the ball can overshoot the screen edge without
+// wrapping, the math is plain integer ops either way.
+typedef int32_t fixed_t;
+#define FIXED_SHIFT 8
+#define FIXED_ONE (1 << FIXED_SHIFT)
+// multiplies, not shifts: shifting a negative value left is undefined
+#define INT_TO_FIXED(i) ((fixed_t)(i) * FIXED_ONE)
+#define FIXED_TO_INT(f) ((int16_t)((f) >> FIXED_SHIFT))
+
+// fixed point multiply / divide, results keep FIXED_SHIFT fractional bits
+static inline fixed_t fixed_mul(fixed_t a, fixed_t b) {
+    return (a * b) >> FIXED_SHIFT;
+}
+
+static inline fixed_t fixed_div(fixed_t a, fixed_t b) {
+    return ((int64_t)a * FIXED_ONE) / b;
+}
+
+// what a ball can run into
+typedef enum {
+    BallHitNone,
+    BallHitWall,
+    BallHitPaddle,
+    BallHitGoalLeft,
+    BallHitGoalRight,
+} BallHit;
+
+// the paddles. each guards one side of the court: a ball meets its face
+// moving along 'axis', touching with its top left corner at 'face', and
+// leaves going 'out' along that axis. where a paddle is, is where its top
+// (or left) end sits along the other axis. the collision code only ever
+// loops over this table and court_edges, so four-sided pong is two more
+// rows here and goal rows in place of the walls there
+typedef enum {
+    PongAxisX, // upright paddle, the ball comes at it sideways
+    PongAxisY, // flat paddle, the ball comes at it from above or below
+} PongAxis;
+
+typedef enum {
+    PaddleCpu,
+    PaddlePlayer,
+    PaddleCount,
+} PaddleId;
+
+typedef struct {
+    uint8_t axis; // PongAxis
+    int8_t out; // +1 or -1
+    int16_t face;
+    // where the paddle's body is on the axis, its x for an upright one
+    int16_t line;
+} PaddleSpec;
+
+static const PaddleSpec paddle_specs[PaddleCount] = {
+    [PaddleCpu] = {.axis = PongAxisX, .out = 1, .face = CPU_X + PADDLE_W, .line = CPU_X},
+    [PaddlePlayer] = {.axis = PongAxisX, .out = -1, .face = PLAYER_X - BALL_W, .line = PLAYER_X},
+};
+
+// the edges of the court, met the same way as a paddle face but all the way
+// across: the ball's top left corner stays on the 'out' side of 'plane'
+// along 'axis', and going past it is a 'hit'. a wall sends the ball back
+// the way it came, a goal scores and serves it again
+typedef struct {
+    uint8_t axis; // PongAxis
+    int8_t out; // +1 or -1
+    int16_t plane;
+    uint8_t hit; // BallHitWall or a goal
+} CourtEdge;
+
+#define COURT_EDGE_COUNT 4
+
+static const CourtEdge court_edges[COURT_EDGE_COUNT] = {
+    {.axis = PongAxisY, .out = 1, .plane = BALL_MIN_Y, .hit = BallHitWall},
+    {.axis = PongAxisY, .out = -1, .plane = BALL_MAX_Y, .hit = BallHitWall},
+    {.axis = PongAxisX, .out = 1, .plane = GOAL_LEFT_X, .hit = BallHitGoalLeft},
+    {.axis = PongAxisX, .out = -1, .plane = GOAL_RIGHT_X, .hit = BallHitGoalRight},
+};
+
+// narrow [lo, hi] on one axis to the side of plane a ball stays on
+static inline void court_narrow(int16_t* const lo, int16_t* const hi, int8_t out, int16_t plane) {
+    if(out > 0 && plane > *lo) *lo = plane;
+    if(out < 0 && plane < *hi) *hi = plane;
+}
+
+// the box, per PongAxis, that a ball's corner can move around in without
+// getting past any paddle face or court edge. a ball whose move ends inside
+// it can't have hit anything
+static void court_free_box(fixed_t lo[2], fixed_t hi[2]) {
+    int16_t box_lo[2] = {INT16_MIN, INT16_MIN};
+    int16_t box_hi[2] = {INT16_MAX, INT16_MAX};
+    for(uint8_t p = 0; p < PaddleCount; p++) {
+        const PaddleSpec* spec = &paddle_specs[p];
+        court_narrow(&box_lo[spec->axis], &box_hi[spec->axis], spec->out, spec->face);
+    }
+    for(uint8_t e = 0; e < COURT_EDGE_COUNT; e++) {
+        const CourtEdge* edge = &court_edges[e];
+        court_narrow(&box_lo[edge->axis], &box_hi[edge->axis], edge->out, edge->plane);
+    }
+    for(uint8_t axis = 0; axis < 2; axis++) {
+        lo[axis] = INT_TO_FIXED(box_lo[axis]);
+        hi[axis] = INT_TO_FIXED(box_hi[axis]);
+    }
+}
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""
+map_compiler.py - turn an ascii tile map into the binary map walk_guy streams
+
+one character per tile, one line per row of tiles:
+
+    .   empty           0
+    ,   grass           1
+    #   wall            2
+    ~   water           3
+    T   tree            4
+
+the map is cut into square chunks of chunk_tiles x chunk_tiles and written
+chunk by chunk, so the game can seek straight to any chunk and read just
+that one. short rows and a ragged bottom edge are padded with walls out to
+a whole number of chunks.
+
+file layout, little endian:
+
+    0   char[4]  magic "WGMP"
+    4   u8       version, 1
+    5   u8       chunk_tiles
+    6   u16      width in tiles (a multiple of chunk_tiles)
+    8   u16      height in tiles (likewise)
+    10  u16      reserved, 0
+    12  chunks, row-major by chunk. each is chunk_tiles^2 / 2 bytes: the
+        chunk's tiles row-major, two per byte, low nibble is the left one.
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = b"WGMP"
+VERSION = 1
+HEADER_SIZE = 12
+
+TILES = {".": 0, ",": 1, "#": 2, "~": 3, "T": 4}
+PAD_TILE = TILES["#"]
+
+
+def parse_map(text):
+    rows = [line.rstrip("\n") for line in text.splitlines()]
+    while rows and not rows[-1].strip():
+        rows.pop()
+    grid = []
+    for y, line in enumerate(rows):
+        row = []
+        for x, ch in enumerate(line):
+            if ch not in TILES:
+                raise ValueError("line %d column %d: unknown tile '%s'" % (y + 1, x + 1, ch))
+            row.append(TILES[ch])
+        grid.append(row)
+    return grid
+
+
+def pack_map(grid, chunk_tiles):
+    if chunk_tiles % 2:
+        raise ValueError("chunk_tiles must be even, tiles are packed two per byte")
+    width = max(len(row) for row in grid)
+    height = len(grid)
+    width = -(-width // chunk_tiles) * chunk_tiles
+    height = -(-height // chunk_tiles) * chunk_tiles
+
+    def tile(x, y):
+        if y < len(grid) and x < len(grid[y]):
+            return grid[y][x]
+        return PAD_TILE
+
+    out = bytearray(MAGIC)
+    out += struct.pack("<BBHHH", VERSION, chunk_tiles, width, height, 0)
+    for cy in range(height // chunk_tiles):
+        for cx in range(width // chunk_tiles):
+            for y in range(cy * chunk_tiles, (cy + 1) * chunk_tiles):
+                for x in range(cx * chunk_tiles, (cx + 1) * chunk_tiles, 2):
+                    out.append(tile(x, y) | (tile(x + 1, y) << 4))
+    return bytes(out), width, height
+
+
+def main():
+    parser = argparse.ArgumentParser(description="compile an ascii tile map into a chunked binary map")
+    parser.add_argument("map", help="ascii map, one character per tile")
+    parser.add_argument("-o", "--output", required=True, help="binary map to write")
+    parser.add_argument("-k", "--chunk-tiles", type=int, default=16, help="chunk edge in tiles (default 16)")
+    args = parser.parse_args()
+
+    with open(args.map) as f:
+        grid = parse_map(f.read())
+    data, width, height = pack_map(grid, args.chunk_tiles)
+    with open(args.output, "wb") as f:
+        f.write(data)
+    chunks = (width // args.chunk_tiles) * (height // args.chunk_tiles)
+    sys.stderr.write(
+        "%dx%d tiles, %d chunks of %d bytes, %d bytes total\n"
+        % (width, height, chunks, args.chunk_tiles * args.chunk_tiles // 2, len(data))
+    )
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,611 @@
+#!/usr/bin/env python3
+"""
+sprite_compiler.py - turn a sprite sheet into packed, const C headers
+
+takes a json manifest that points at a BMP or PNG sheet and says how the
+sheet is cut into frames, and writes a header with one const array per
+asset. frames are 1 bit per pixel, xbm bit order (lsb = leftmost pixel),
+rows padded to whole bytes, so a 16x16 frame is 32 bytes.
+
+manifest:
+
+    {
+        "sheet": "walk_guy.bmp",      // relative to the manifest
+        "frame_w": 16,
+        "frame_h": 16,
+        "threshold": 128,             // luma below this is a set pixel
+        "invert": false,              // set pixels are light instead of dark
+        "compress": "none",           // none | rle | heatshrink
+        "prefix": "SPRITE",           // names the size macros, PREFIX_W etc.
+        "assets": [
+            // sheet row 0, frames 0..2 left to right
+            {"name": "down", "row": 0, "frames": 3},
+            {"name": "up", "row": 1, "frames": 3, "col": 0},
+            // also emit a collision mask per frame, see below
+            {"name": "enemy", "row": 4, "frames": 2, "mask": "filled"},
+            // left flipped, see below
+            {"name": "right", "mirror": "left", "mask": "filled"}
+        ]
+    }
+
+mirrored assets are an earlier asset flipped left to right. their frames
+aren't stored at all, the game draws the other asset with BlitFlagMirror
+(walk_guy/sprite_blit.h). masks are still emitted, already flipped. with
+a "row" the sheet's frames there are checked against the flipped ones.
+
+collision masks (frames up to 16 wide, always uncompressed):
+
+    <name>_mask[frames][PREFIX_H], one uint16_t per row, bit 0 is the
+    leftmost pixel like the packed frames.
+    "pixels"    exactly the set pixels
+    "filled"    each row filled from its leftmost to its rightmost set
+                pixel, so outline drawings collide as solid shapes
+
+compression formats (per frame, so frames can be decoded independently):
+
+    rle         control byte c, then
+                c < 0x80:  c + 1 literal bytes follow
+                c >= 0x80: the next byte repeats c - 0x7e times (2..129)
+
+    heatshrink  lzss bitstream, window 2^8, lookahead 2^4, msb first.
+                1 + 8 bits literal, or 0 + 8 bits (offset - 1) + 4 bits
+                (count - 1). same settings the firmware uses for icons.
+
+asset packs (--pack FILE): the frames go into a file for the sd card
+instead of the header, which then only has the sizes, asset ids and masks.
+each frame is stored with the manifest's compression, or raw where that
+comes out smaller. little endian:
+
+    0   char[4]  magic "WGPK"
+    4   u8       version, 1
+    5   u8       frame_w
+    6   u8       frame_h
+    7   u8       reserved, 0
+    8   u16      asset count
+    10  u16      frame count
+    12  assets, 16 bytes each:
+            char[12] name, nul padded
+            u16      first frame
+            u16      frames
+        frames, 8 bytes each:
+            u32      offset of the data from the start of the file
+            u16      length of the data
+            u8       codec: 0 none, 1 rle, 2 heatshrink
+            u8       reserved, 0
+        frame data
+
+prints a report to stderr: raw against stored bytes per asset, for the frames
+actually written out, then the index (pack) or offset tables on their own.
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+import zlib
+
+HS_WINDOW_BITS = 8
+HS_LOOKAHEAD_BITS = 4
+
+
+class Image:
+    def __init__(self, width, height, luma):
+        self.width = width
+        self.height = height
+        # row-major list of 0..255 luma values, top row first
+        self.luma = luma
+
+    def pixel(self, x, y):
+        return self.luma[y * self.width + x]
+
+
+def _luma(r, g, b):
+    return (r * 299 + g * 587 + b * 114) // 1000
+
+
+def load_bmp(data):
+    if data[:2] != b"BM":
+        raise ValueError("not a bmp file")
+    pixel_offset = struct.unpack_from("<I", data, 10)[0]
+    header_size = struct.unpack_from("<I", data, 14)[0]
+    width, height = struct.unpack_from("<ii", data, 18)
+    bpp = struct.unpack_from("<H", data, 28)[0]
+    compression = struct.unpack_from("<I", data, 30)[0]
+    if compression not in (0, 3):
+        raise ValueError("compressed bmp not supported")
+    top_down = height < 0
+    height = abs(height)
+
+    palette = []
+    if bpp <= 8:
+        colors = struct.unpack_from("<I", data, 46)[0] or (1 << bpp)
+        base = 14 + header_size
+        for i in range(colors):
+            b, g, r = data[base + i * 4 : base + i * 4 + 3]
+            palette.append(_luma(r, g, b))
+
+    stride = ((width * bpp + 31) // 32) * 4
+    luma = [0] * (width * height)
+    for row in range(height):
+        y = row if top_down else height - 1 - row
+        line = data[pixel_offset + row * stride : pixel_offset + (row + 1) * stride]
+        for x in range(width):
+            if bpp <= 8:
+                bit = x * bpp
+                idx = (line[bit // 8] >> (8 - bpp - bit % 8)) & ((1 << bpp) - 1)
+                value = palette[idx]
+            elif bpp in (24, 32):
+                b, g, r = line[x * bpp // 8 : x * bpp // 8 + 3]
+                value = _luma(r, g, b)
+            else:
+                raise ValueError("unsupported bmp depth %d" % bpp)
+            luma[y * width + x] = value
+    return Image(width, height, luma)
+
+
+def _paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def load_png(data):
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError("not a png file")
+    pos = 8
+    idat = b""
+    palette = []
+    while pos < len(data):
+        length, kind = struct.unpack_from(">I4s", data, pos)
+        body = data[pos + 8 : pos + 8 + length]
+        pos += 12 + length
+        if kind == b"IHDR":
+            width, height, depth, color_type, _, _, interlace = struct.unpack(">IIBBBBB", body)
+            if interlace:
+                raise ValueError("interlaced png not supported")
+        elif kind == b"PLTE":
+            palette = [_luma(*body[i : i + 3]) for i in range(0, len(body), 3)]
+        elif kind == b"IDAT":
+            idat += body
+        elif kind == b"IEND":
+            break
+
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color_type]
+    bits_pp = channels * depth
+    bpp = max(1, bits_pp // 8)
+    stride = (width * bits_pp + 7) // 8
+    raw = zlib.decompress(idat)
+    prev = bytearray(stride)
+    luma = [0] * (width * height)
+    for y in range(height):
+        ftype = raw[y * (stride + 1)]
+        line = bytearray(raw[y * (stride + 1) + 1 : (y + 1) * (stride + 1)])
+        for i in range(stride):
+            a = line[i - bpp] if i >= bpp else 0
+            b = prev[i]
+            c = prev[i - bpp] if i >= bpp else 0
+            if ftype == 1:
+                line[i] = (line[i] + a) & 0xFF
+            elif ftype == 2:
+                line[i] = (line[i] + b) & 0xFF
+            elif ftype == 3:
+                line[i] = (line[i] + (a + b) // 2) & 0xFF
+            elif ftype == 4:
+                line[i] = (line[i] + _paeth(a, b, c)) & 0xFF
+        prev = line
+        for x in range(width):
+            if depth < 8:
+                bit = x * depth
+                sample = (line[bit // 8] >> (8 - depth - bit % 8)) & ((1 << depth) - 1)
+                if color_type == 3:
+                    value = palette[sample]
+                else:
+                    value = sample * 255 // ((1 << depth) - 1)
+            else:
+                step = depth // 8
+                px = [line[(x * channels + ch) * step] for ch in range(channels)]
+                if color_type == 3:
+                    value = palette[px[0]]
+                elif color_type in (0, 4):
+                    value = px[0]
+                else:
+                    value = _luma(*px[:3])
+                # fully transparent pixels count as background
+                if color_type in (4, 6) and px[-1] < 128:
+                    value = 255
+            luma[y * width + x] = value
+    return Image(width, height, luma)
+
+
+def load_sheet(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:2] == b"BM":
+        return load_bmp(data)
+    return load_png(data)
+
+
+def pack_frame(image, x0, y0, w, h, threshold, invert):
+    row_bytes = (w + 7) // 8
+    out = bytearray(row_bytes * h)
+    for y in range(h):
+        for x in range(w):
+            set_px = image.pixel(x0 + x, y0 + y) < threshold
+            if invert:
+                set_px = not set_px
+            if set_px:
+                out[y * row_bytes + x // 8] |= 1 << (x % 8)
+    return bytes(out)
+
+
+def mirror_frame(frame, w, h):
+    row_bytes = (w + 7) // 8
+    out = bytearray()
+    for row in range(h):
+        bits = int.from_bytes(frame[row * row_bytes : (row + 1) * row_bytes], "little")
+        flipped = int(format(bits, "0%db" % w)[::-1], 2)
+        out += flipped.to_bytes(row_bytes, "little")
+    return bytes(out)
+
+
+def rle_encode(data):
+    out = bytearray()
+    literal = bytearray()
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and data[i + run] == data[i] and run < 129:
+            run += 1
+        if run >= 2:
+            while literal:
+                chunk = literal[:128]
+                out.append(len(chunk) - 1)
+                out += chunk
+                literal = literal[128:]
+            out.append(0x7E + run)
+            out.append(data[i])
+            i += run
+        else:
+            literal.append(data[i])
+            i += 1
+    while literal:
+        chunk = literal[:128]
+        out.append(len(chunk) - 1)
+        out += chunk
+        literal = literal[128:]
+    return bytes(out)
+
+
+class _BitWriter:
+    def __init__(self):
+        self.out = bytearray()
+        self.acc = 0
+        self.nbits = 0
+
+    def put(self, value, count):
+        for shift in range(count - 1, -1, -1):
+            self.acc = (self.acc << 1) | ((value >> shift) & 1)
+            self.nbits += 1
+            if self.nbits == 8:
+                self.out.append(self.acc)
+                self.acc = 0
+                self.nbits = 0
+
+    def finish(self):
+        if self.nbits:
+            self.out.append(self.acc << (8 - self.nbits))
+        return bytes(self.out)
+
+
+def heatshrink_encode(data, window_bits=HS_WINDOW_BITS, lookahead_bits=HS_LOOKAHEAD_BITS):
+    window = 1 << window_bits
+    max_count = 1 << lookahead_bits
+    bits = _BitWriter()
+    i = 0
+    while i < len(data):
+        best_len, best_off = 0, 0
+        for off in range(1, min(i, window) + 1):
+            n = 0
+            while n < max_count and i + n < len(data) and data[i + n - off] == data[i + n]:
+                n += 1
+            if n > best_len:
+                best_len, best_off = n, off
+        # a backref costs 1 + W + L bits, a literal 9
+        if best_len * 9 > 1 + window_bits + lookahead_bits:
+            bits.put(0, 1)
+            bits.put(best_off - 1, window_bits)
+            bits.put(best_len - 1, lookahead_bits)
+            i += best_len
+        else:
+            bits.put(1, 1)
+            bits.put(data[i], 8)
+            i += 1
+    return bits.finish()
+
+
+ENCODERS = {
+    "none": lambda data: data,
+    "rle": rle_encode,
+    "heatshrink": heatshrink_encode,
+}
+
+PACK_MAGIC = b"WGPK"
+PACK_VERSION = 1
+PACK_NAME_LEN = 12
+PACK_CODECS = {"none": 0, "rle": 1, "heatshrink": 2}
+
+
+def _row_comment(frame, row, w):
+    row_bytes = (w + 7) // 8
+    line = frame[row * row_bytes : (row + 1) * row_bytes]
+    return "".join("#" if line[x // 8] & (1 << (x % 8)) else "." for x in range(w))
+
+
+def build_mask(frame, w, h, kind):
+    row_bytes = (w + 7) // 8
+    rows = []
+    for row in range(h):
+        bits = int.from_bytes(frame[row * row_bytes : (row + 1) * row_bytes], "little")
+        if kind == "filled" and bits:
+            left = (bits & -bits).bit_length() - 1
+            right = bits.bit_length()
+            bits = ((1 << right) - 1) & ~((1 << left) - 1)
+        rows.append(bits)
+    return rows
+
+
+PACK_HEADER_SIZE = 12
+PACK_ASSET_SIZE = 16
+PACK_FRAME_SIZE = 8
+
+
+def pack_chunk(raw, encoded, compress):
+    """codec and bytes a pack stores for one frame, the raw frame when
+    compressing doesn't make it smaller"""
+    if len(encoded) < len(raw):
+        return PACK_CODECS[compress], encoded
+    return PACK_CODECS["none"], raw
+
+
+def build_pack(manifest, assets):
+    compress = manifest.get("compress", "none")
+    # mirrored assets are drawn from the asset they mirror
+    assets = [asset for asset in assets if not asset["mirror"]]
+    frame_count = sum(len(asset["frames"]) for asset in assets)
+    out = bytearray(PACK_MAGIC)
+    out += struct.pack("<BBBBHH", PACK_VERSION, manifest["frame_w"], manifest["frame_h"], 0, len(assets), frame_count)
+    first = 0
+    for asset in assets:
+        name = asset["name"].encode()
+        if len(name) > PACK_NAME_LEN:
+            raise ValueError("asset name '%s' is longer than %d" % (asset["name"], PACK_NAME_LEN))
+        out += name.ljust(PACK_NAME_LEN, b"\0") + struct.pack("<HH", first, len(asset["frames"]))
+        first += len(asset["frames"])
+
+    offset = len(out) + 8 * frame_count
+    data = bytearray()
+    for asset in assets:
+        for raw, encoded in zip(asset["frames"], asset["encoded"]):
+            codec, chunk = pack_chunk(raw, encoded, compress)
+            out += struct.pack("<IHBB", offset + len(data), len(chunk), codec, 0)
+            data += chunk
+    return bytes(out + data)
+
+
+def emit_header(manifest, assets, source_name, pack_name=None):
+    w, h = manifest["frame_w"], manifest["frame_h"]
+    compress = "none" if pack_name else manifest.get("compress", "none")
+    prefix = manifest.get("prefix", "SPRITE")
+    row_bytes = (w + 7) // 8
+    lines = [
+        "#pragma once",
+        "",
+        "#include <stdint.h>",
+        "",
+        "// generated by tools/sprite_compiler.py from %s, do not edit by hand." % source_name,
+        "//",
+        "// %dx%d sprites, 1 bit per pixel, packed xbm style:" % (w, h),
+        "// %d byte%s per row, low byte first, lsb is the leftmost pixel."
+        % (row_bytes, "" if row_bytes == 1 else "s"),
+    ]
+    if pack_name:
+        lines += [
+            "// the frames themselves are in %s, see common/asset_pack.h." % pack_name,
+            "// <PREFIX>_ASSET_<NAME> is the asset's index in there.",
+            "",
+        ]
+    else:
+        lines += [
+            "// const so they stay in flash instead of being copied into ram.",
+            "",
+        ]
+    lines += [
+        "#define %s_W %d" % (prefix, w),
+        "#define %s_H %d" % (prefix, h),
+        ("#define {0}_ROW_BYTES ({0}_W / 8)" if w % 8 == 0 else "#define {0}_ROW_BYTES (({0}_W + 7) / 8)").format(prefix),
+        "#define {0}_FRAME_BYTES ({0}_ROW_BYTES * {0}_H)".format(prefix),
+        "",
+    ]
+    if compress != "none":
+        lines += [
+            "// frames are %s compressed, see tools/sprite_compiler.py for the format." % compress,
+            "// <name>_sprite_offsets[i] .. [i + 1] is the byte range of frame i.",
+            "",
+        ]
+
+    if pack_name:
+        index = 0
+        for asset in assets:
+            macro = "%s_ASSET_%s" % (prefix, asset["name"].upper())
+            if asset["mirror"]:
+                lines.append("#define %s %s_ASSET_%s" % (macro, prefix, asset["mirror"].upper()))
+            else:
+                lines.append("#define %s %d" % (macro, index))
+                index += 1
+            lines.append("#define %s_FRAMES %d" % (macro, len(asset["frames"])))
+            lines.append("#define %s_MIRROR %d" % (macro, 1 if asset["mirror"] else 0))
+        lines.append("")
+
+    for asset in assets:
+        name = asset["name"]
+        frames = asset["frames"]
+        if pack_name:
+            # frames are in the pack
+            pass
+        elif asset["mirror"]:
+            lines.append("// %s_sprite: %s_sprite drawn with BlitFlagMirror" % (name, asset["mirror"]))
+        elif compress == "none":
+            lines.append("static const uint8_t %s_sprite[%d][%s_FRAME_BYTES] = {" % (name, len(frames), prefix))
+            for frame in frames:
+                lines.append("    {")
+                for row in range(h):
+                    line = frame[row * row_bytes : (row + 1) * row_bytes]
+                    data = ", ".join("0x%02x" % b for b in line)
+                    lines.append("        %s, // %s" % (data, _row_comment(frame, row, w)))
+                lines.append("    },")
+            lines.append("};")
+        else:
+            encoded = asset["encoded"]
+            offsets = [0]
+            for chunk in encoded:
+                offsets.append(offsets[-1] + len(chunk))
+            lines.append(
+                "static const uint16_t %s_sprite_offsets[%d] = {%s};"
+                % (name, len(offsets), ", ".join(str(o) for o in offsets))
+            )
+            lines.append("static const uint8_t %s_sprite_data[%d] = {" % (name, offsets[-1]))
+            for i, chunk in enumerate(encoded):
+                lines.append("    // frame %d" % i)
+                for start in range(0, len(chunk), 12):
+                    lines.append("    %s," % ", ".join("0x%02x" % b for b in chunk[start : start + 12]))
+            lines.append("};")
+        if asset["masks"]:
+            lines.append("static const uint16_t %s_mask[%d][%s_H] = {" % (name, len(frames), prefix))
+            for mask in asset["masks"]:
+                lines.append("    {")
+                for bits in mask:
+                    comment = "".join("#" if bits & (1 << x) else "." for x in range(w))
+                    lines.append("        0x%04x, // %s" % (bits, comment))
+                lines.append("    },")
+            lines.append("};")
+        if not pack_name or asset["masks"]:
+            lines.append("")
+    return "\n".join(lines)
+
+
+def compile_manifest(manifest_path, compress_override=None):
+    with open(manifest_path) as f:
+        manifest = json.load(f)
+    if compress_override:
+        manifest["compress"] = compress_override
+    compress = manifest.get("compress", "none")
+    if compress not in ENCODERS:
+        raise ValueError("unknown compression '%s'" % compress)
+
+    sheet_path = os.path.join(os.path.dirname(manifest_path), manifest["sheet"])
+    image = load_sheet(sheet_path)
+    w, h = manifest["frame_w"], manifest["frame_h"]
+    threshold = manifest.get("threshold", 128)
+    invert = manifest.get("invert", False)
+
+    assets = []
+    by_name = {}
+    for entry in manifest["assets"]:
+        name = entry["name"]
+        mirror = entry.get("mirror")
+        sheet_frames = []
+        if "row" in entry:
+            row = entry["row"]
+            col = entry.get("col", 0)
+            count = entry.get("frames", len(by_name[mirror]["frames"]) if mirror in by_name else 0)
+            for i in range(count):
+                x0, y0 = (col + i) * w, row * h
+                if x0 + w > image.width or y0 + h > image.height:
+                    raise ValueError("asset '%s' frame %d is outside the sheet" % (name, i))
+                sheet_frames.append(pack_frame(image, x0, y0, w, h, threshold, invert))
+        if mirror:
+            source = by_name.get(mirror)
+            if not source or source["mirror"]:
+                raise ValueError("asset '%s' mirrors '%s', which isn't an earlier unmirrored asset" % (name, mirror))
+            frames = [mirror_frame(frame, w, h) for frame in source["frames"]]
+            if "row" in entry and sheet_frames != frames:
+                raise ValueError("asset '%s' on the sheet isn't '%s' mirrored" % (name, mirror))
+            encoded = []
+        else:
+            frames = sheet_frames
+            encoded = [ENCODERS[compress](frame) for frame in frames]
+        masks = []
+        kind = entry.get("mask")
+        if kind:
+            if kind not in ("pixels", "filled"):
+                raise ValueError("asset '%s' has unknown mask '%s'" % (entry["name"], kind))
+            if w > 16:
+                raise ValueError("asset '%s' is too wide for uint16_t mask rows" % entry["name"])
+            masks = [build_mask(frame, w, h, kind) for frame in frames]
+        asset = {"name": name, "frames": frames, "encoded": encoded, "masks": masks, "mirror": mirror}
+        assets.append(asset)
+        by_name[name] = asset
+    return manifest, assets
+
+
+def report(assets, compress, packed=False, out=sys.stderr):
+    """raw against stored bytes of the frames that actually get written out.
+    mirrored assets store nothing and stay out of the totals. what it takes
+    to find the frames (the pack's header and index, or the offset tables
+    next to compressed data) is a line of its own"""
+    stored_label = "stored" if compress == "none" else compress
+    out.write("%-12s %6s %8s %10s %6s\n" % ("asset", "frames", "raw", stored_label, "ratio"))
+    total_raw = total_stored = index = 0
+    emitted = [asset for asset in assets if not asset["mirror"]]
+    for asset in assets:
+        if asset["mirror"]:
+            out.write("%-12s %6d   %s mirrored, nothing stored\n" % (asset["name"], len(asset["frames"]), asset["mirror"]))
+            continue
+        raw = sum(len(f) for f in asset["frames"])
+        if packed:
+            stored = sum(len(pack_chunk(f, e, compress)[1]) for f, e in zip(asset["frames"], asset["encoded"]))
+        else:
+            stored = sum(len(e) for e in asset["encoded"])
+            if compress != "none":
+                index += 2 * (len(asset["frames"]) + 1)
+        total_raw += raw
+        total_stored += stored
+        out.write("%-12s %6d %8d %10d %5.0f%%\n" % (asset["name"], len(asset["frames"]), raw, stored, 100.0 * stored / raw))
+    if packed:
+        frame_count = sum(len(asset["frames"]) for asset in emitted)
+        index = PACK_HEADER_SIZE + PACK_ASSET_SIZE * len(emitted) + PACK_FRAME_SIZE * frame_count
+    ratio = 100.0 * total_stored / total_raw if total_raw else 0.0
+    out.write("%-12s %6s %8d %10d %5.0f%%\n" % ("frames", "", total_raw, total_stored, ratio))
+    out.write("%-12s %6s %8s %10d\n" % ("pack index" if packed else "offsets", "", "", index))
+    out.write("%-12s %6s %8s %10d\n" % ("total", "", "", total_stored + index))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="compile a sprite sheet into packed c headers")
+    parser.add_argument("manifest", help="json manifest describing the sheet")
+    parser.add_argument("-o", "--output", help="header to write (default: stdout)")
+    parser.add_argument("-c", "--compress", choices=sorted(ENCODERS), help="override the manifest compression")
+    parser.add_argument("-p", "--pack", help="write the frames to this asset pack instead of the header")
+    args = parser.parse_args()
+
+    manifest, assets = compile_manifest(args.manifest, args.compress)
+    pack_name = None
+    if args.pack:
+        pack_name = os.path.basename(args.pack)
+        with open(args.pack, "wb") as f:
+            f.write(build_pack(manifest, assets))
+    header = emit_header(manifest, assets, os.path.basename(args.manifest), pack_name)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(header)
+    else:
+        sys.stdout.write(header)
+    report(assets, manifest.get("compress", "none"), packed=bool(args.pack))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <gui/gui.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../common/asset_pack.h"
+#include "../common/fixed_step.h"
+#include "sprite_blit.h"
+#include "walk_sprites.h"
+
+// tiny archetype style entity storage. every kind of actor (an archetype)
+// gets its own table: a count plus one statically sized array per component
+// it has, rows 0..count-1 always packed. spawning appends a row, despawning
+// moves the last row into the hole, so systems never skip dead slots. a
+// system is a plain function over the component arrays it needs, and runs
+// once per table that has them.
+//
+// tables live inside the game state by value (no pointers), so the state
+// can still be copied into render snapshots as a block.
+
+// world pixels, the world is bigger than the screen
+typedef struct {
+    int16_t x, y;
+    // position before the last logic step, for interpolation
+    int16_t prev_x, prev_y;
+} Position;
+
+// pixels per logic step
+typedef struct {
+    int8_t dx, dy;
+} Velocity;
+
+// which animation (an index into the game's EcsAnim table) and frame of it
+typedef struct {
+    uint8_t anim;
+    uint8_t frame;
+} Sprite;
+
+// size of the hit box, the sprite's mask narrows it down when there is one
+typedef struct {
+    uint8_t w, h;
+} Collider;
+
+// logic steps left before the entity expires
+typedef struct {
+    uint8_t steps;
+} Lifetime;
+
+// one row of the game's animation table. the frames are an asset in the
+// game's sprite pack, the masks are compiled in since logic needs them.
+// mirror draws the asset flipped, the masks are already the flipped ones
+typedef struct {
+    uint8_t asset;
+    const uint16_t (*masks)[SPRITE_H];
+    uint8_t frame_count;
+    bool mirror;
+} EcsAnim;
+
+static inline int16_t lerp_position(int16_t prev, int16_t cur, uint8_t alpha) {
+    return fixed_step_lerp(prev, cur, alpha);
+}
+
+static inline void ecs_position_set(Position* const position, int16_t x, int16_t y) {
+    // fresh position, nothing to interpolate from
+    position->x = position->prev_x = x;
+    position->y = position->prev_y = y;
+}
+
+// remove row 'row' of a table column by moving the last row into it. call
+// once per column, then drop the count
+#define ECS_SWAP_REMOVE(table, column, row) ((table)->column[row] = (table)->column[(table)->count - 1])
+
+// motion: remember where everything was, then move it by its velocity
+static void ecs_motion(Position* const positions, const Velocity* const velocities, uint16_t count) {
+    for(uint16_t i = 0; i < count; i++) {
+        positions[i].prev_x = positions[i].x;
+        positions[i].prev_y = positions[i].y;
+        positions[i].x += velocities[i].dx;
+        positions[i].y += velocities[i].dy;
+    }
+}
+
+// aging: count every lifetime down, returns true if any reached zero
+static bool ecs_age(Lifetime* const lifetimes, uint16_t count) {
+    bool expired = false;
+    for(uint16_t i = 0; i < count; i++) {
+        if(lifetimes[i].steps) lifetimes[i].steps--;
+        expired |= !lifetimes[i].steps;
+    }
+    return expired;
+}
+
+// a frame's mask as a packed frame
+static void ecs_mask_frame(const uint16_t* mask, uint8_t* frame) {
+    for(uint8_t row = 0; row < SPRITE_H; row++) {
+        for(uint8_t b = 0; b < SPRITE_ROW_BYTES; b++) {
+            frame[row * SPRITE_ROW_BYTES + b] = mask[row] >> (b * 8);
+        }
+    }
+}
+
+// different frames that can be on screen at once
+#define SPRITE_VIEW_FRAMES 8
+
+// the frames of the sprites on screen, copied out of the game's pack by the
+// game loop so drawing never touches the pack (or the sd card). lives in the
+// state by value, so every snapshot carries the frames it draws. a frame
+// stays until a new one needs its slot, the pack is only asked when a
+// sprite changes
+typedef struct {
+    uint8_t count;
+    // bit per slot some sprite needed since ecs_view_begin, the others can
+    // be given to new frames
+    uint8_t used;
+    Sprite sprite[SPRITE_VIEW_FRAMES];
+    bool mirror[SPRITE_VIEW_FRAMES];
+    uint8_t frame[SPRITE_VIEW_FRAMES][SPRITE_FRAME_BYTES];
+} SpriteView;
+
+_Static_assert(SPRITE_VIEW_FRAMES <= 8, "SpriteView.used has a bit per slot");
+
+// slot holding sprite's frame, or -1
+static int8_t ecs_view_find(const SpriteView* const view, Sprite sprite) {
+    for(uint8_t i = 0; i < view->count; i++) {
+        if(view->sprite[i].anim == sprite.anim && view->sprite[i].frame == sprite.frame) return i;
+    }
+    return -1;
+}
+
+// read sprite's frame from the pack into slot. a frame the pack can't give
+// us is its mask instead, so things still show up as silhouettes
+static void ecs_view_load(
+    SpriteView* const view,
+    uint8_t slot,
+    AssetPack* const pack,
+    const EcsAnim* const anims,
+    Sprite sprite) {
+    const EcsAnim* anim = &anims[sprite.anim];
+    const uint8_t* frame = asset_pack_frame(pack, anim->asset, sprite.frame);
+    view->sprite[slot] = sprite;
+    if(frame) {
+        memcpy(view->frame[slot], frame, SPRITE_FRAME_BYTES);
+        view->mirror[slot] = anim->mirror;
+    } else {
+        // the masks are already flipped
+        ecs_mask_frame(anim->masks[sprite.frame], view->frame[slot]);
+        view->mirror[slot] = false;
+    }
+}
+
+// start over on which frames are needed, call before the ecs_view_sprites
+static inline void ecs_view_begin(SpriteView* const view) {
+    view->used = 0;
+}
+
+// make sure the view has a frame for each of sprites 0..count-1, reading
+// new ones from the pack. game loop only, the pack isn't thread safe. with
+// every slot needed already a sprite gets no frame and isn't drawn
+static void ecs_view_sprites(
+    SpriteView* const view,
+    AssetPack* const pack,
+    const EcsAnim* const anims,
+    const Sprite* const sprites,
+    uint16_t count) {
+    for(uint16_t i = 0; i < count; i++) {
+        int8_t slot = ecs_view_find(view, sprites[i]);
+        if(slot < 0) {
+            if(view->count < SPRITE_VIEW_FRAMES) {
+                slot = view->count++;
+            } else if(view->used != (uint8_t)((1u << SPRITE_VIEW_FRAMES) - 1)) {
+                slot = __builtin_ctz(~view->used);
+            } else {
+                continue;
+            }
+            ecs_view_load(view, slot, pack, anims, sprites[i]);
+        }
+        view->used |= 1u << slot;
+    }
+}
+
+// draw every sprite at its interpolated position, cam_x,cam_y is the world
+// position of the screen's top left corner. the frames come from the view
+static void ecs_draw_sprites(
+    Canvas* const canvas,
+    const SpriteView* const view,
+    const Position* const positions,
+    const Sprite* const sprites,
+    uint16_t count,
+    uint8_t alpha,
+    int16_t cam_x,
+    int16_t cam_y) {
+    for(uint16_t i = 0; i < count; i++) {
+        int8_t slot = ecs_view_find(view, sprites[i]);
+        if(slot < 0) continue;
+        sprite_blit(
+            canvas,
+            lerp_position(positions[i].prev_x, positions[i].x, alpha) - cam_x,
+            lerp_position(positions[i].prev_y, positions[i].y, alpha) - cam_y,
+            SPRITE_W,
+            SPRITE_H,
+            view->frame[slot],
+            view->mirror[slot] ? BlitModeSet | BlitFlagMirror : BlitModeSet);
+    }
+}
+
+// draw every collider as a filled box, for things with no sprite
+static void ecs_draw_boxes(
+    Canvas* const canvas,
+    const Position* const positions,
+    const Collider* const colliders,
+    uint16_t count,
+    uint8_t alpha,
+    int16_t cam_x,
+    int16_t cam_y) {
+    const int16_t canvas_w = canvas_width(canvas);
+    const int16_t canvas_h = canvas_height(canvas);
+    for(uint16_t i = 0; i < count; i++) {
+        int16_t x0 = lerp_position(positions[i].prev_x, positions[i].x, alpha) - cam_x;
+        int16_t y0 = lerp_position(positions[i].prev_y, positions[i].y, alpha) - cam_y;
+        int16_t x1 = x0 + colliders[i].w;
+        int16_t y1 = y0 + colliders[i].h;
+        // canvas coords are unsigned, clip here
+        if(x0 < 0) x0 = 0;
+        if(y0 < 0) y0 = 0;
+        if(x1 > canvas_w) x1 = canvas_w;
+        if(y1 > canvas_h) y1 = canvas_h;
+        if(x0 < x1 && y0 < y1) {
+            canvas_draw_box(canvas, x0, y0, x1 - x0, y1 - y0);
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ecs.h"
+
+// uniform grid broadphase over one screen's worth of the world. rebuilt from scratch every logic
+// step: count how many items land in each cell, prefix-sum the counts into
+// bucket offsets, then drop every item into its bucket (a counting sort, two
+// passes, no per-cell lists). a query then only looks at the few cells its
+// box can reach instead of at every item.
+//
+// an item is filed under the cell holding its top-left corner, so a query
+// box reaches back by the item size to catch items that start in a
+// neighbouring cell and stick into this one. the grid sits at an origin in
+// world pixels (the camera), items off it land in the edge cells.
+
+#define SPATIAL_GRID_W 128
+#define SPATIAL_GRID_H 64
+#define SPATIAL_GRID_COLS 8
+#define SPATIAL_GRID_ROWS 8
+#define SPATIAL_GRID_CELL_W (SPATIAL_GRID_W / SPATIAL_GRID_COLS)
+#define SPATIAL_GRID_CELL_H (SPATIAL_GRID_H / SPATIAL_GRID_ROWS)
+#define SPATIAL_GRID_CELLS (SPATIAL_GRID_COLS * SPATIAL_GRID_ROWS)
+
+// define before including to change it, item ids are uint8_t
+#ifndef SPATIAL_GRID_MAX_ITEMS
+#define SPATIAL_GRID_MAX_ITEMS 64
+#endif
+
+typedef struct {
+    // items in cell c are items[cell_start[c] .. cell_start[c + 1])
+    uint16_t cell_start[SPATIAL_GRID_CELLS + 1];
+    uint8_t items[SPATIAL_GRID_MAX_ITEMS];
+    // scratch, which cell each id went into during the build
+    uint8_t item_cell[SPATIAL_GRID_MAX_ITEMS];
+    // every item's size, queries widen by this much
+    uint8_t item_w, item_h;
+    // world position of the grid's top left corner
+    int16_t origin_x, origin_y;
+} SpatialGrid;
+
+// called for each item a query turns up, return false to stop the query
+typedef bool (*SpatialGridVisit)(uint8_t id, void* context);
+
+// off-grid coordinates clamp to the edge cells
+static inline uint8_t spatial_grid_col(int16_t x) {
+    if(x < 0) return 0;
+    if(x >= SPATIAL_GRID_W) return SPATIAL_GRID_COLS - 1;
+    return x / SPATIAL_GRID_CELL_W;
+}
+
+static inline uint8_t spatial_grid_row(int16_t y) {
+    if(y < 0) return 0;
+    if(y >= SPATIAL_GRID_H) return SPATIAL_GRID_ROWS - 1;
+    return y / SPATIAL_GRID_CELL_H;
+}
+
+// file rows 0..count-1 of a table by their top-left corner, the id is the
+// row. all items are item_w x item_h.
+static void spatial_grid_build(
+    SpatialGrid* const grid,
+    int16_t origin_x,
+    int16_t origin_y,
+    const Position* const positions,
+    uint16_t count,
+    uint8_t item_w,
+    uint8_t item_h) {
+    if(count > SPATIAL_GRID_MAX_ITEMS) count = SPATIAL_GRID_MAX_ITEMS;
+    grid->item_w = item_w;
+    grid->item_h = item_h;
+    grid->origin_x = origin_x;
+    grid->origin_y = origin_y;
+    memset(grid->cell_start, 0, sizeof(grid->cell_start));
+
+    // count, shifted up one so the prefix sum below yields start offsets
+    for(uint8_t id = 0; id < count; id++) {
+        uint8_t cell = spatial_grid_row(positions[id].y - origin_y) * SPATIAL_GRID_COLS +
+                       spatial_grid_col(positions[id].x - origin_x);
+        grid->item_cell[id] = cell;
+        grid->cell_start[cell + 1]++;
+    }
+    for(uint8_t cell = 0; cell < SPATIAL_GRID_CELLS; cell++) {
+        grid->cell_start[cell + 1] += grid->cell_start[cell];
+    }
+
+    // scatter, each bucket's start offset doubles as its write cursor
+    uint16_t cursor[SPATIAL_GRID_CELLS];
+    memcpy(cursor, grid->cell_start, sizeof(cursor));
+    for(uint8_t id = 0; id < count; id++) {
+        grid->items[cursor[grid->item_cell[id]]++] = id;
+    }
+}
+
+// visit every item filed in a cell the box x,y,w,h (world pixels) could
+// overlap. this is only the broadphase, the visitor still does the exact
+// overlap test.
+static void spatial_grid_query(
+    const SpatialGrid* const grid,
+    int16_t x,
+    int16_t y,
+    uint8_t w,
+    uint8_t h,
+    SpatialGridVisit visit,
+    void* context) {
+    x -= grid->origin_x;
+    y -= grid->origin_y;
+    uint8_t col0 = spatial_grid_col(x - grid->item_w + 1);
+    uint8_t col1 = spatial_grid_col(x + w - 1);
+    uint8_t row0 = spatial_grid_row(y - grid->item_h + 1);
+    uint8_t row1 = spatial_grid_row(y + h - 1);
+    for(uint8_t row = row0; row <= row1; row++) {
+        // cells in a row are contiguous, so are their buckets
+        uint16_t start = grid->cell_start[row * SPATIAL_GRID_COLS + col0];
+        uint16_t end = grid->cell_start[row * SPATIAL_GRID_COLS + col1 + 1];
+        for(uint16_t i = start; i < end; i++) {
+            if(!visit(grid->items[i], context)) return;
+        }
+    }
+}
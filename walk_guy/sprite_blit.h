@@ -0,0 +1,95 @@
+#pragma once
+
+#include <gui/gui.h>
+
+#include <stdint.h>
+
+// how set pixels of a sprite land on the canvas. clear pixels are always
+// transparent, they never touch what's already drawn.
+typedef enum {
+    BlitModeSet, // set pixels drawn black
+    BlitModeClear, // set pixels drawn white (erase)
+    BlitModeXor, // set pixels invert whatever is under them
+    BlitModeMask = 0x0F,
+    // or'd into the mode: draw the sprite flipped left to right, so one
+    // stored frame serves for both facings
+    BlitFlagMirror = 0x10,
+} BlitMode;
+
+// bits 0..w-1 of a row in reverse order, the row mirrored
+static inline uint32_t sprite_mirror_bits(uint32_t bits, uint8_t w) {
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+    // one instruction on the cortex-m4
+    __asm__("rbit %0, %1" : "=r"(bits) : "r"(bits));
+#else
+    bits = ((bits >> 1) & 0x55555555u) | ((bits & 0x55555555u) << 1);
+    bits = ((bits >> 2) & 0x33333333u) | ((bits & 0x33333333u) << 2);
+    bits = ((bits >> 4) & 0x0F0F0F0Fu) | ((bits & 0x0F0F0F0Fu) << 4);
+    bits = __builtin_bswap32(bits);
+#endif
+    return bits >> (32 - w);
+}
+
+// read one packed row (xbm order, lsb = leftmost pixel) of up to 32 pixels
+static inline uint32_t sprite_row_bits(const uint8_t* row, uint8_t row_bytes) {
+    uint32_t bits = 0;
+    for(uint8_t i = 0; i < row_bytes; i++) {
+        bits |= (uint32_t)row[i] << (i * 8);
+    }
+    return bits;
+}
+
+// draw every run of set pixels in a row as one 1px high box.
+// x is the screen column of bit 0, bits are already clipped.
+static inline void sprite_blit_spans(Canvas* const canvas, int16_t x, int16_t y, uint32_t bits) {
+    while(bits) {
+        uint8_t start = __builtin_ctz(bits);
+        uint32_t rest = bits >> start;
+        // length of the run of ones starting at bit 'start'
+        uint8_t len = (~rest) ? __builtin_ctz(~rest) : 32 - start;
+        canvas_draw_box(canvas, x + start, y, len, 1);
+        bits &= (len + start >= 32) ? 0 : (0xFFFFFFFFu << (start + len));
+    }
+}
+
+// blit a packed 1bpp sprite, at most 32 pixels wide, with clipping.
+// cost scales with the number of horizontal runs, not with pixel count.
+// mode is a BlitMode, optionally | BlitFlagMirror.
+static void sprite_blit(
+    Canvas* const canvas,
+    int16_t x,
+    int16_t y,
+    uint8_t w,
+    uint8_t h,
+    const uint8_t* bitmap,
+    BlitMode mode) {
+    const bool mirror = mode & BlitFlagMirror;
+    mode &= BlitModeMask;
+    const int16_t canvas_w = canvas_width(canvas);
+    const int16_t canvas_h = canvas_height(canvas);
+    if(x >= canvas_w || y >= canvas_h || x + w <= 0 || y + h <= 0) {
+        return;
+    }
+
+    const uint8_t row_bytes = (w + 7) / 8;
+    uint32_t col_mask = (w >= 32) ? 0xFFFFFFFFu : ((1u << w) - 1);
+    // clip columns once, every row uses the same mask
+    if(x < 0) {
+        col_mask &= 0xFFFFFFFFu << (-x);
+    }
+    if(x + w > canvas_w) {
+        col_mask &= 0xFFFFFFFFu >> (32 - (canvas_w - x));
+    }
+    uint8_t row = (y < 0) ? -y : 0;
+    uint8_t row_end = (y + h > canvas_h) ? canvas_h - y : h;
+
+    canvas_set_color(canvas, mode == BlitModeXor ? ColorXOR : mode == BlitModeClear ? ColorWhite : ColorBlack);
+    for(; row < row_end; row++) {
+        uint32_t bits = sprite_row_bits(&bitmap[row * row_bytes], row_bytes);
+        // mirror before clipping, the column mask is in screen order
+        if(mirror) bits = sprite_mirror_bits(bits, w);
+        bits &= col_mask;
+        sprite_blit_spans(canvas, x, y + row, bits);
+    }
+    canvas_set_color(canvas, ColorBlack);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// per-pixel collision between sprites. a mask is one uint16_t per row, bit 0
+// the leftmost pixel, same as the packed frames (tools/sprite_compiler.py
+// writes them next to the sprites). shapes up to 16 pixels wide.
+
+// do two masks overlap anywhere. a is aw x ah at ax,ay, b likewise. the
+// box test goes first, so pairs that don't touch never look at a row.
+static bool sprite_masks_overlap(
+    const uint16_t* a,
+    int16_t ax,
+    int16_t ay,
+    uint8_t aw,
+    uint8_t ah,
+    const uint16_t* b,
+    int16_t bx,
+    int16_t by,
+    uint8_t bw,
+    uint8_t bh) {
+    if(ax >= bx + bw || bx >= ax + aw || ay >= by + bh || by >= ay + ah) {
+        return false;
+    }
+    // b's column c sits in a's column c + dx, |dx| < 16 after the box test
+    int16_t dx = bx - ax;
+    // only the rows both masks cover
+    int16_t top = ay > by ? ay : by;
+    int16_t bottom = (ay + ah < by + bh) ? ay + ah : by + bh;
+    for(int16_t y = top; y < bottom; y++) {
+        uint32_t a_row = a[y - ay];
+        uint32_t b_row = b[y - by];
+        b_row = dx >= 0 ? b_row << dx : b_row >> -dx;
+        if(a_row & b_row) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+
+// generated by tools/sprite_compiler.py from tiles.json, do not edit by hand.
+//
+// 8x8 sprites, 1 bit per pixel, packed xbm style:
+// 1 byte per row, low byte first, lsb is the leftmost pixel.
+// const so they stay in flash instead of being copied into ram.
+
+#define TILE_W 8
+#define TILE_H 8
+#define TILE_ROW_BYTES (TILE_W / 8)
+#define TILE_FRAME_BYTES (TILE_ROW_BYTES * TILE_H)
+
+static const uint8_t tile_sprite[5][TILE_FRAME_BYTES] = {
+    {
+        0x00, // ........
+        0x00, // ........
+        0x00, // ........
+        0x00, // ........
+        0x00, // ........
+        0x00, // ........
+        0x00, // ........
+        0x00, // ........
+    },
+    {
+        0x00, // ........
+        0x00, // ........
+        0x04, // ..#.....
+        0x0a, // .#.#....
+        0x00, // ........
+        0x20, // .....#..
+        0x50, // ....#.#.
+        0x00, // ........
+    },
+    {
+        0xff, // ########
+        0x08, // ...#....
+        0x08, // ...#....
+        0xff, // ########
+        0x80, // .......#
+        0x80, // .......#
+        0xff, // ########
+        0x08, // ...#....
+    },
+    {
+        0x00, // ........
+        0x06, // .##.....
+        0x49, // #..#..#.
+        0x30, // ....##..
+        0x00, // ........
+        0x18, // ...##...
+        0x25, // #.#..#..
+        0x00, // ........
+    },
+    {
+        0x3c, // ..####..
+        0x42, // .#....#.
+        0x89, // #..#...#
+        0xa1, // #....#.#
+        0x42, // .#....#.
+        0x3c, // ..####..
+        0x18, // ...##...
+        0x3c, // ..####..
+    },
+};
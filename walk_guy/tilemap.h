@@ -0,0 +1,195 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "tile_sprites.h"
+
+// tile map bigger than the screen, streamed from a file on the sd card a
+// chunk at a time. the file is what tools/map_compiler.py writes: a small
+// header, then square chunks of 4-bit tiles, so any chunk is one seek and
+// one read. only TILEMAP_RESIDENT_CHUNKS chunks are in ram at once, enough
+// to cover the screen plus a tile of margin wherever it is.
+//
+// owned by the game loop thread, it does file io.
+
+#define TILEMAP_MAGIC "WGMP"
+#define TILEMAP_VERSION 1
+#define TILEMAP_HEADER_SIZE 12
+#define TILEMAP_MAX_CHUNK_TILES 16
+#define TILEMAP_CHUNK_BYTES (TILEMAP_MAX_CHUNK_TILES * TILEMAP_MAX_CHUNK_TILES / 2)
+// a view up to one chunk tall and a bit over one chunk wide touches 3x2
+#define TILEMAP_RESIDENT_CHUNKS 6
+#define TILEMAP_NO_CHUNK -1
+
+// map size when there's no map file, an empty field
+#define TILEMAP_DEFAULT_WIDTH 64
+#define TILEMAP_DEFAULT_HEIGHT 32
+
+// tile ids, see tools/map_compiler.py
+#define TILE_EMPTY 0
+#define TILE_GRASS 1
+#define TILE_WALL 2
+#define TILE_WATER 3
+#define TILE_TREE 4
+// ids the tables in the game have rows for, 0..TILE_COUNT-1
+#define TILE_COUNT 5
+// anything off the map, or not loaded, or an id we don't know, reads as this
+#define TILE_OUTSIDE TILE_WALL
+
+typedef struct {
+    // which chunk this slot holds, cx is TILEMAP_NO_CHUNK while free
+    int16_t cx, cy;
+    // tiles row-major, two per byte, low nibble is the left one
+    uint8_t tiles[TILEMAP_CHUNK_BYTES];
+} TilemapChunk;
+
+typedef struct {
+    Storage* storage;
+    // NULL when there's no usable map file, every tile is then empty
+    File* file;
+    uint16_t width, height; // in tiles
+    uint8_t chunk_tiles;
+    uint16_t chunk_cols; // chunks per row of the map
+    TilemapChunk chunks[TILEMAP_RESIDENT_CHUNKS];
+    // chunks read from the file so far
+    uint32_t chunk_loads;
+} Tilemap;
+
+static inline uint16_t tilemap_chunk_bytes(const Tilemap* const map) {
+    return map->chunk_tiles * map->chunk_tiles / 2;
+}
+
+// check the header and take the map size from it
+static bool tilemap_read_header(Tilemap* const map) {
+    uint8_t header[TILEMAP_HEADER_SIZE];
+    if(storage_file_read(map->file, header, sizeof(header)) != sizeof(header)) return false;
+    if(memcmp(header, TILEMAP_MAGIC, 4) || header[4] != TILEMAP_VERSION) return false;
+    uint8_t chunk_tiles = header[5];
+    uint16_t width = header[6] | (header[7] << 8);
+    uint16_t height = header[8] | (header[9] << 8);
+    if(!chunk_tiles || chunk_tiles > TILEMAP_MAX_CHUNK_TILES || chunk_tiles % 2) return false;
+    if(!width || !height || width % chunk_tiles || height % chunk_tiles) return false;
+    map->chunk_tiles = chunk_tiles;
+    map->width = width;
+    map->height = height;
+    return true;
+}
+
+// open the map at path. a missing or broken file isn't fatal, the map is
+// then an empty field of the default size
+static Tilemap* tilemap_alloc(const char* path) {
+    Tilemap* map = malloc(sizeof(Tilemap));
+    memset(map, 0, sizeof(Tilemap));
+    for(uint8_t i = 0; i < TILEMAP_RESIDENT_CHUNKS; i++) {
+        map->chunks[i].cx = TILEMAP_NO_CHUNK;
+    }
+    map->storage = furi_record_open(RECORD_STORAGE);
+    map->file = storage_file_alloc(map->storage);
+    if(!storage_file_open(map->file, path, FSAM_READ, FSOM_OPEN_EXISTING) || !tilemap_read_header(map)) {
+        FURI_LOG_W("Tilemap", "no usable map at %s, using an empty one", path);
+        storage_file_free(map->file);
+        map->file = NULL;
+        map->chunk_tiles = TILEMAP_MAX_CHUNK_TILES;
+        map->width = TILEMAP_DEFAULT_WIDTH;
+        map->height = TILEMAP_DEFAULT_HEIGHT;
+    }
+    map->chunk_cols = map->width / map->chunk_tiles;
+    return map;
+}
+
+static void tilemap_free(Tilemap* const map) {
+    if(map->file) {
+        storage_file_close(map->file);
+        storage_file_free(map->file);
+    }
+    furi_record_close(RECORD_STORAGE);
+    free(map);
+}
+
+static inline uint16_t tilemap_width_px(const Tilemap* const map) {
+    return map->width * TILE_W;
+}
+
+static inline uint16_t tilemap_height_px(const Tilemap* const map) {
+    return map->height * TILE_H;
+}
+
+static const TilemapChunk* tilemap_find_chunk(const Tilemap* const map, int16_t cx, int16_t cy) {
+    for(uint8_t i = 0; i < TILEMAP_RESIDENT_CHUNKS; i++) {
+        if(map->chunks[i].cx == cx && map->chunks[i].cy == cy) return &map->chunks[i];
+    }
+    return NULL;
+}
+
+// make any tile id past the ones we know outside. tiles are 4 bits, a
+// corrupt map or one from a newer compiler can hold up to 15, and the game
+// indexes tables with them
+static void tilemap_check_tiles(uint8_t* tiles, uint16_t bytes) {
+    for(uint16_t b = 0; b < bytes; b++) {
+        uint8_t left = tiles[b] & 0x0F, right = tiles[b] >> 4;
+        if(left >= TILE_COUNT) left = TILE_OUTSIDE;
+        if(right >= TILE_COUNT) right = TILE_OUTSIDE;
+        tiles[b] = left | (right << 4);
+    }
+}
+
+// read one chunk into a slot
+static void tilemap_load_chunk(Tilemap* const map, TilemapChunk* const chunk, int16_t cx, int16_t cy) {
+    chunk->cx = cx;
+    chunk->cy = cy;
+    uint16_t bytes = tilemap_chunk_bytes(map);
+    if(!map->file) {
+        memset(chunk->tiles, 0, bytes);
+        return;
+    }
+    uint32_t offset = TILEMAP_HEADER_SIZE + (uint32_t)(cy * map->chunk_cols + cx) * bytes;
+    if(!storage_file_seek(map->file, offset, true) || storage_file_read(map->file, chunk->tiles, bytes) != bytes) {
+        FURI_LOG_E("Tilemap", "chunk %d,%d: short read", cx, cy);
+        memset(chunk->tiles, TILE_OUTSIDE | (TILE_OUTSIDE << 4), bytes);
+    } else {
+        tilemap_check_tiles(chunk->tiles, bytes);
+    }
+    map->chunk_loads++;
+}
+
+// make sure every chunk under the pixel rect x,y,w,h is resident, reusing
+// slots of chunks the rect doesn't touch
+static void tilemap_stream(Tilemap* const map, int16_t x, int16_t y, uint16_t w, uint16_t h) {
+    const int16_t chunk_px_w = map->chunk_tiles * TILE_W;
+    const int16_t chunk_px_h = map->chunk_tiles * TILE_H;
+    int16_t cx0 = x < 0 ? 0 : x / chunk_px_w;
+    int16_t cy0 = y < 0 ? 0 : y / chunk_px_h;
+    int16_t cx1 = (x + w - 1) / chunk_px_w;
+    int16_t cy1 = (y + h - 1) / chunk_px_h;
+    if(cx1 >= map->chunk_cols) cx1 = map->chunk_cols - 1;
+    if(cy1 >= map->height / map->chunk_tiles) cy1 = map->height / map->chunk_tiles - 1;
+
+    for(int16_t cy = cy0; cy <= cy1; cy++) {
+        for(int16_t cx = cx0; cx <= cx1; cx++) {
+            if(tilemap_find_chunk(map, cx, cy)) continue;
+            // any slot holding a chunk outside the rect will do
+            for(uint8_t i = 0; i < TILEMAP_RESIDENT_CHUNKS; i++) {
+                TilemapChunk* slot = &map->chunks[i];
+                if(slot->cx == TILEMAP_NO_CHUNK || slot->cx < cx0 || slot->cx > cx1 || slot->cy < cy0 ||
+                   slot->cy > cy1) {
+                    tilemap_load_chunk(map, slot, cx, cy);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// tile at tile coords tx,ty. off the map or not resident reads as outside
+static uint8_t tilemap_get(const Tilemap* const map, int16_t tx, int16_t ty) {
+    if(tx < 0 || ty < 0 || tx >= map->width || ty >= map->height) return TILE_OUTSIDE;
+    const TilemapChunk* chunk = tilemap_find_chunk(map, tx / map->chunk_tiles, ty / map->chunk_tiles);
+    if(!chunk) return TILE_OUTSIDE;
+    uint16_t i = (ty % map->chunk_tiles) * map->chunk_tiles + (tx % map->chunk_tiles);
+    return (chunk->tiles[i / 2] >> ((i & 1) * 4)) & 0x0F;
+}
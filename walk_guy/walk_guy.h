@@ -1,16 +1,23 @@
 #pragma once
 
 #include <furi.h>
-#include <furi_hal_random.h>
 #include <gui/gui.h>
 #include <input/input.h>
 #include <notification/notification.h>
 #include <notification/notification_messages.h>
+#include <storage/storage.h>
 
 #include <stdlib.h>
 #include <stdbool.h>
 
+#include "../common/game_runtime.h"
+#include "../common/game_sounds.h"
 #include "walk_sprites.h"
+#include "sprite_blit.h"
+#include "ecs.h"
+#include "spatial_grid.h"
+#include "sprite_mask.h"
+#include "tilemap.h"
 
 #define ARRAY_LEN(array) (sizeof(array) / sizeof(array[0]))
 #define NUM_ROWS(array_2d) ARRAY_LEN(array_2d)
@@ -18,9 +25,23 @@
 
 #define DEBUG_TEXT 0
 
+// game logic rate and how often we ask for a redraw. logic runs at exactly
+// LOGIC_HZ no matter how fast frames come, drawing interpolates in between.
+#define LOGIC_HZ 4
+#define FRAME_HZ 60
+
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 
+// the world, see tools/map_compiler.py. copy walk_guy/maps/world.map here
+#define WALK_MAP_PATH EXT_PATH("apps_data/walk_guy/world.map")
+// the sprite frames, walk_guy/sprites/walk_guy.pack
+#define WALK_SPRITES_PATH EXT_PATH("apps_data/walk_guy/sprites.pack")
+// tiles kept for drawing: the screen, plus one tile either way so both ends
+// of a camera move between two steps are covered
+#define VIEW_COLS (SCREEN_WIDTH / TILE_W + 2)
+#define VIEW_ROWS (SCREEN_HEIGHT / TILE_H + 2)
+
 #define START_X 40
 #define START_Y 30
 #define PLAYER_SPEED 2
@@ -31,230 +52,591 @@
 #define PLAYER_W 16
 #define PLAYER_H 16
 #define PLAYER_FRAMES 3
+// the part of the player that bumps into walls, its feet. narrower than
+// the sprite so it fits through a two tile gap
+#define PLAYER_FEET_X 3
+#define PLAYER_FEET_Y 8
+#define PLAYER_FEET_W 10
+#define PLAYER_FEET_H 8
+
+#define ENEMY_W 16
+#define ENEMY_H 16
+#define ENEMY_COUNT 6
+// logic steps before a shot enemy shows up again somewhere else
+#define ENEMY_RESPAWN_STEPS 8
+
+// table sizes. all static, the whole world is part of PluginState
+#define PROJECTILE_CAPACITY 256
+#define ENEMY_CAPACITY 32
+// steps a projectile lives even if it never leaves the screen
+#define PROJECTILE_LIFETIME 32
 
 #define UP 0
 #define DOWN 1
 #define LEFT 2
 #define RIGHT 3
 
+// animations, see walk_anims. the player's is its direction
+#define ANIM_UP UP
+#define ANIM_DOWN DOWN
+#define ANIM_LEFT LEFT
+#define ANIM_RIGHT RIGHT
+#define ANIM_ENEMY 4
+
+// right is left mirrored, only left's frames are stored
+static const EcsAnim walk_anims[] = {
+    [ANIM_UP] = {SPRITE_ASSET_UP, up_mask, SPRITE_ASSET_UP_FRAMES, SPRITE_ASSET_UP_MIRROR},
+    [ANIM_DOWN] = {SPRITE_ASSET_DOWN, down_mask, SPRITE_ASSET_DOWN_FRAMES, SPRITE_ASSET_DOWN_MIRROR},
+    [ANIM_LEFT] = {SPRITE_ASSET_LEFT, left_mask, SPRITE_ASSET_LEFT_FRAMES, SPRITE_ASSET_LEFT_MIRROR},
+    [ANIM_RIGHT] = {SPRITE_ASSET_RIGHT, right_mask, SPRITE_ASSET_RIGHT_FRAMES, SPRITE_ASSET_RIGHT_MIRROR},
+    [ANIM_ENEMY] = {SPRITE_ASSET_ENEMY, enemy_mask, SPRITE_ASSET_ENEMY_FRAMES, SPRITE_ASSET_ENEMY_MIRROR},
+};
+
+// what only the player has: which way it faces and whether it's walking
+typedef struct {
+    uint8_t speed, dir;
+    bool is_moving;
+} PlayerControl;
 
-// 0= clock tick 1= key press
-typedef enum {
-    EventTypeTick,
-    EventTypeKey,
-} EventType;
+// the archetypes. one table each, see ecs.h
 
-// struct to hold events, to be put in event queue
+// always exactly one row
 typedef struct {
-    EventType type;
-    InputEvent input;
-} PluginEvent;
+    uint16_t count;
+    Position position[1];
+    Velocity velocity[1];
+    Sprite sprite[1];
+    Collider collider[1];
+    PlayerControl control[1];
+} PlayerTable;
 
 typedef struct {
-    uint8_t x, y, speed, dir;
-    bool visible;
+    uint16_t count;
+    Position position[PROJECTILE_CAPACITY];
+    Velocity velocity[PROJECTILE_CAPACITY];
+    Collider collider[PROJECTILE_CAPACITY];
+    Lifetime lifetime[PROJECTILE_CAPACITY];
+} ProjectileTable;
+
+// enemies just stand there and wait to be shot
+typedef struct {
+    uint16_t count;
+    Position position[ENEMY_CAPACITY];
+    Sprite sprite[ENEMY_CAPACITY];
+    Collider collider[ENEMY_CAPACITY];
+} EnemyTable;
 
-} Projectile;
+// a shot enemy, waiting to come back somewhere else
+typedef struct {
+    uint16_t count;
+    Lifetime lifetime[ENEMY_CAPACITY];
+} RespawnTable;
 
 typedef struct {
-    uint8_t x, y, speed, dir;
-    bool is_moving;
-    uint8_t frame;
-    // uint8_t sprite[][PLAYER_H][PLAYER_W];
-    uint8_t * sprite;
-    Projectile projectile;
-} Player;
+    PlayerTable player;
+    ProjectileTable projectiles;
+    EnemyTable enemies;
+    RespawnTable respawns;
+} World;
+
+// the tiles around the camera, copied out of the streamed map after every
+// step so drawing never touches the map (or the sd card)
+typedef struct {
+    // tile coords of tiles[0][0]
+    int16_t tx, ty;
+    uint8_t tiles[VIEW_ROWS][VIEW_COLS];
+} TileView;
 
-// mutex to hold global states one might want to fuck with
+// global states one might want to fuck with. owned by the game loop, the
+// gui only ever sees snapshots of it
 typedef struct {
-    Player player;
+    World world;
+    // world position of the screen's top left corner, follows the player
+    Position camera;
+    TileView view;
+    // the sprite frames on screen, the same idea as view
+    SpriteView sprite_view;
+    // game loop only, snapshots carry the pointers but drawing uses the views
+    Tilemap* map;
+    AssetPack* sprites;
+    uint16_t kills;
+    // how far into the next logic step this frame is, 0..255
+    uint8_t render_alpha;
 
 } PluginState;
 
-static void draw_player(PluginState* const plugin_state, Canvas* const canvas, uint8_t sprite[][PLAYER_H][PLAYER_W]) {
-    for(size_t row=0; row<PLAYER_H; row++) {
-        for(size_t col=0; col<PLAYER_W; col++) {
-            uint8_t f = plugin_state->player.frame;
-            if(sprite[f][row][col]) {
-                canvas_draw_dot(canvas, col + plugin_state->player.x, row + plugin_state->player.y);
-            }
+// only the tiles on screen, one blit each. empty tiles draw nothing
+static void draw_tiles(const TileView* const view, Canvas* const canvas, int16_t cam_x, int16_t cam_y) {
+    for(uint8_t row = 0; row < VIEW_ROWS; row++) {
+        int16_t y = (view->ty + row) * TILE_H - cam_y;
+        if(y <= -TILE_H || y >= SCREEN_HEIGHT) continue;
+        for(uint8_t col = 0; col < VIEW_COLS; col++) {
+            uint8_t tile = view->tiles[row][col];
+            int16_t x = (view->tx + col) * TILE_W - cam_x;
+            if(tile == TILE_EMPTY || x <= -TILE_W || x >= SCREEN_WIDTH) continue;
+            sprite_blit(canvas, x, y, TILE_W, TILE_H, tile_sprite[tile], BlitModeSet);
         }
     }
 }
 
-static void draw_projectile(PluginState* const plugin_state, Canvas* const canvas) {
-    if(plugin_state->player.projectile.x < 0 || plugin_state->player.projectile.x > SCREEN_WIDTH
-    || plugin_state->player.projectile.y < 0 || plugin_state->player.projectile.y > SCREEN_HEIGHT) {
-        plugin_state->player.projectile.visible = false;
-    }
-    if(plugin_state->player.projectile.visible) {
-        canvas_draw_box(canvas, plugin_state->player.projectile.x, plugin_state->player.projectile.y, PROJECTILE_W, PROJECTILE_H);
+static void draw_all(const PluginState* const plugin_state, Canvas* const canvas) {
+    const World* world = &plugin_state->world;
+    uint8_t alpha = plugin_state->render_alpha;
+    int16_t cam_x = lerp_position(plugin_state->camera.prev_x, plugin_state->camera.x, alpha);
+    int16_t cam_y = lerp_position(plugin_state->camera.prev_y, plugin_state->camera.y, alpha);
+
+    draw_tiles(&plugin_state->view, canvas, cam_x, cam_y);
+    ecs_draw_sprites(
+        canvas,
+        &plugin_state->sprite_view,
+        world->enemies.position,
+        world->enemies.sprite,
+        world->enemies.count,
+        alpha,
+        cam_x,
+        cam_y);
+    ecs_draw_sprites(
+        canvas,
+        &plugin_state->sprite_view,
+        world->player.position,
+        world->player.sprite,
+        world->player.count,
+        alpha,
+        cam_x,
+        cam_y);
+    ecs_draw_boxes(
+        canvas, world->projectiles.position, world->projectiles.collider, world->projectiles.count, alpha, cam_x, cam_y);
+
+    if(plugin_state->kills) {
+        char buf[6];
+        snprintf(buf, sizeof(buf), "%u", plugin_state->kills);
+        canvas_draw_str_aligned(canvas, SCREEN_WIDTH - 1, 0, AlignRight, AlignTop, buf);
     }
 }
 
-static void shoot(PluginState* const plugin_state) {
-    if(!plugin_state->player.projectile.visible) {
-        plugin_state->player.projectile.dir = plugin_state->player.dir;
-        uint8_t dir = plugin_state->player.projectile.dir;
-        switch(dir) {
-            case UP:
-                plugin_state->player.projectile.x = plugin_state->player.x + (PLAYER_W / 2);
-                plugin_state->player.projectile.y = plugin_state->player.y - PROJECTILE_H;
-                break;
-            case DOWN:
-                plugin_state->player.projectile.x = plugin_state->player.x + (PLAYER_W / 2);
-                plugin_state->player.projectile.y = plugin_state->player.y + PLAYER_H;
-                break;
-            case LEFT:
-                plugin_state->player.projectile.x = plugin_state->player.x/* - PROJECTILE_W*/;
-                plugin_state->player.projectile.y = plugin_state->player.y + (PLAYER_H / 2);
-                break;
-            case RIGHT:
-                plugin_state->player.projectile.x = plugin_state->player.x + PLAYER_W - PROJECTILE_W;
-                plugin_state->player.projectile.y = plugin_state->player.y + (PLAYER_H / 2);
-                break;
-        }
-        plugin_state->player.projectile.visible = true;
-    }
+static void spawn_projectile(World* const world, int16_t x, int16_t y, int8_t dx, int8_t dy) {
+    ProjectileTable* projectiles = &world->projectiles;
+    if(projectiles->count >= PROJECTILE_CAPACITY) return;
+    uint16_t i = projectiles->count++;
+    ecs_position_set(&projectiles->position[i], x, y);
+    projectiles->velocity[i] = (Velocity){dx, dy};
+    projectiles->collider[i] = (Collider){PROJECTILE_W, PROJECTILE_H};
+    projectiles->lifetime[i] = (Lifetime){PROJECTILE_LIFETIME};
 }
 
-const NotificationSequence sequence_player_score = {
-    &message_vibro_on,
-    &message_green_255,
-    &message_note_c4,
-    &message_delay_50,
-    &message_note_e4,
-    &message_delay_50,
-    &message_blue_255,
-    &message_note_g5,
-    &message_delay_50,
-    &message_note_a5,
-    &message_delay_100,
-    &message_note_c6,
-    &message_delay_100,
-    &message_sound_off,
-    &message_vibro_off,
-    &message_green_0,
-    &message_blue_0,
-    NULL,
-};
-
-const NotificationSequence sequence_cpu_score = {
-    &message_vibro_on,
-    &message_green_255,
-    &message_note_ds4,
-    &message_delay_50,
-    &message_note_d4,
-    &message_delay_50,
-    &message_red_255,
-    &message_note_a2,
-    &message_delay_250,
-    &message_sound_off,
-    &message_vibro_off,
-    &message_green_0,
-    &message_blue_0,
-    NULL,
-};
-
-const NotificationSequence sequence_blip = {
-    &message_vibro_on,
-    &message_note_ds4,
-    &message_delay_10,
-    &message_note_f4,
-    &message_delay_10,
-    &message_note_g4,
-    &message_delay_10,
-    &message_sound_off,
-    &message_vibro_off,
-    NULL,
-};
+static void despawn_projectile(World* const world, uint16_t i) {
+    ProjectileTable* projectiles = &world->projectiles;
+    ECS_SWAP_REMOVE(projectiles, position, i);
+    ECS_SWAP_REMOVE(projectiles, velocity, i);
+    ECS_SWAP_REMOVE(projectiles, collider, i);
+    ECS_SWAP_REMOVE(projectiles, lifetime, i);
+    projectiles->count--;
+}
 
-static void draw_all(PluginState* const plugin_state, Canvas* const canvas) {
+// per direction movement, indexed by UP/DOWN/LEFT/RIGHT
+static const int8_t dir_dx[] = {[UP] = 0, [DOWN] = 0, [LEFT] = -1, [RIGHT] = 1};
+static const int8_t dir_dy[] = {[UP] = -1, [DOWN] = 1, [LEFT] = 0, [RIGHT] = 0};
 
-    // player
-    uint8_t dir = plugin_state->player.dir;
+// fire one more projectile, as long as there's room
+static void shoot(PluginState* const plugin_state) {
+    const PlayerTable* player = &plugin_state->world.player;
+    int16_t x = player->position[0].x, y = player->position[0].y;
+    uint8_t dir = player->control[0].dir;
     switch(dir) {
         case UP:
-            draw_player(plugin_state, canvas, up_array);
+            x += PLAYER_W / 2;
+            y -= PROJECTILE_H;
             break;
         case DOWN:
-            draw_player(plugin_state, canvas, down_array);
+            x += PLAYER_W / 2;
+            y += PLAYER_H;
             break;
         case LEFT:
-            draw_player(plugin_state, canvas, left_array);
+            /* x -= PROJECTILE_W; */
+            y += PLAYER_H / 2;
             break;
         case RIGHT:
-            draw_player(plugin_state, canvas, right_array);
+            x += PLAYER_W - PROJECTILE_W;
+            y += PLAYER_H / 2;
             break;
     }
+    spawn_projectile(&plugin_state->world, x, y, dir_dx[dir] * PROJECTILE_SPEED, dir_dy[dir] * PROJECTILE_SPEED);
+}
+
+// direction for each arrow key, indexed by InputKey
+static const uint8_t key_dir[] = {
+    [InputKeyUp] = UP,
+    [InputKeyDown] = DOWN,
+    [InputKeyRight] = RIGHT,
+    [InputKeyLeft] = LEFT,
+};
+
+// apply one poll of the keys. walking follows whichever arrow is held, the
+// most recently pressed one wins when several are. ok shoots on press.
+static void walk_input(PluginState* const plugin_state, const InputFrame* const input) {
+    PlayerControl* control = &plugin_state->world.player.control[0];
+    uint32_t held_dirs = input->held & INPUT_DIRECTION_KEYS;
+    uint32_t new_dirs = input->pressed & held_dirs;
+    if(new_dirs) {
+        control->dir = key_dir[__builtin_ctz(new_dirs)];
+    } else if(held_dirs) {
+        // keep the current direction while its key stays down
+        bool still_held = false;
+        for(InputKey key = InputKeyUp; key <= InputKeyLeft; key++) {
+            if((held_dirs & INPUT_KEY_BIT(key)) && key_dir[key] == control->dir) {
+                still_held = true;
+            }
+        }
+        if(!still_held) {
+            control->dir = key_dir[__builtin_ctz(held_dirs)];
+        }
+    }
+    control->is_moving = held_dirs != 0;
+    // face the way we're going right away, not on the next step
+    plugin_state->world.player.sprite[0].anim = control->dir;
+    if(!control->is_moving) {
+        plugin_state->world.player.sprite[0].frame = 0;
+    }
+
+    if(input->pressed & INPUT_KEY_BIT(InputKeyOk)) {
+        shoot(plugin_state);
+    }
+}
+
+// nothing on screen can change until a key goes down: standing still, the
+// last step's interpolation has settled, no projectile is in flight and no
+// enemy is waiting to come back
+static bool walk_is_idle(const PluginState* const plugin_state, const InputFrame* const input) {
+    const World* world = &plugin_state->world;
+    const Position* position = &world->player.position[0];
+    const Position* camera = &plugin_state->camera;
+    return !input->held && !world->player.control[0].is_moving && !world->projectiles.count &&
+           !world->respawns.count && position->prev_x == position->x && position->prev_y == position->y &&
+           camera->prev_x == camera->x && camera->prev_y == camera->y;
+}
+
+// tiles the player can't walk through, and ones that stop projectiles
+static const bool tile_blocks_walking[TILE_COUNT] = {
+    [TILE_EMPTY] = false,
+    [TILE_GRASS] = false,
+    [TILE_WALL] = true,
+    [TILE_WATER] = true,
+    [TILE_TREE] = true,
+};
+static const bool tile_blocks_shots[TILE_COUNT] = {
+    [TILE_EMPTY] = false,
+    [TILE_GRASS] = false,
+    [TILE_WALL] = true,
+    [TILE_WATER] = false,
+    [TILE_TREE] = true,
+};
+// the tilemap never hands out an id these don't cover
+_Static_assert(ARRAY_LEN(tile_sprite) == TILE_COUNT, "a tile sprite per tile id");
+
+static inline int16_t floor_div(int16_t a, int16_t b) {
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+// does any tile under the pixel box x,y,w,h have its flag set
+static bool tiles_in_box(const Tilemap* const map, const bool* flags, int16_t x, int16_t y, uint8_t w, uint8_t h) {
+    int16_t tx0 = floor_div(x, TILE_W), tx1 = floor_div(x + w - 1, TILE_W);
+    int16_t ty0 = floor_div(y, TILE_H), ty1 = floor_div(y + h - 1, TILE_H);
+    for(int16_t ty = ty0; ty <= ty1; ty++) {
+        for(int16_t tx = tx0; tx <= tx1; tx++) {
+            if(flags[tilemap_get(map, tx, ty)]) return true;
+        }
+    }
+    return false;
+}
+
+static inline bool boxes_overlap(
+    int16_t ax, int16_t ay, uint8_t aw, uint8_t ah, int16_t bx, int16_t by, uint8_t bw, uint8_t bh) {
+    return ax < bx + bw && bx < ax + aw && ay < by + bh && by < ay + ah;
+}
+
+// projectiles are solid little boxes
+static const uint16_t projectile_mask[PROJECTILE_H] = {0x0003, 0x0003};
+
+static inline const uint16_t* sprite_mask(const Sprite* const sprite) {
+    return walk_anims[sprite->anim].masks[sprite->frame];
+}
+
+// what an enemy query is looking for, and what it found
+typedef struct {
+    const EnemyTable* enemies;
+    // enemies already shot this step, by row
+    uint32_t skip;
+    const uint16_t* mask;
+    int16_t x, y;
+    uint8_t w, h;
+    int8_t hit;
+} EnemyQuery;
+
+static bool enemy_query_visit(uint8_t id, EnemyQuery* query) {
+    if(query->skip & (1u << id)) return true;
+    const Position* position = &query->enemies->position[id];
+    const Collider* collider = &query->enemies->collider[id];
+    if(!sprite_masks_overlap(
+           query->mask, query->x, query->y, query->w, query->h,
+           sprite_mask(&query->enemies->sprite[id]), position->x, position->y, collider->w, collider->h)) {
+        return true;
+    }
+    query->hit = id;
+    return false;
+}
+
+// first enemy whose pixels touch the mask's, or -1. the grid must hold the
+// enemy table's rows
+static int8_t enemy_at(
+    const SpatialGrid* const grid,
+    const EnemyTable* const enemies,
+    uint32_t skip,
+    const uint16_t* mask,
+    int16_t x,
+    int16_t y,
+    uint8_t w,
+    uint8_t h) {
+    EnemyQuery query = {.enemies = enemies, .skip = skip, .mask = mask, .x = x, .y = y, .w = w, .h = h, .hit = -1};
+    spatial_grid_query(grid, x, y, w, h, (SpatialGridVisit)enemy_query_visit, &query);
+    return query.hit;
+}
+
+// add an enemy somewhere on screen, trying a few times for a spot clear of
+// the player, the other enemies and the walls. false if there was none,
+// try again next step
+static bool spawn_enemy(World* const world, const Position* const camera, const Tilemap* const map) {
+    EnemyTable* enemies = &world->enemies;
+    if(enemies->count >= ENEMY_CAPACITY) return false;
+    const Position* player = &world->player.position[0];
+    int16_t x, y;
+    bool clear = false;
+    for(uint8_t attempt = 0; !clear && attempt < 8; attempt++) {
+        x = camera->x + game_random_get() % (SCREEN_WIDTH - ENEMY_W + 1);
+        y = camera->y + game_random_get() % (SCREEN_HEIGHT - ENEMY_H + 1);
+        clear = !boxes_overlap(x, y, ENEMY_W, ENEMY_H, player->x, player->y, PLAYER_W, PLAYER_H) &&
+                !tiles_in_box(map, tile_blocks_walking, x, y, ENEMY_W, ENEMY_H);
+        for(uint16_t j = 0; clear && j < enemies->count; j++) {
+            clear = !boxes_overlap(x, y, ENEMY_W, ENEMY_H, enemies->position[j].x, enemies->position[j].y, ENEMY_W, ENEMY_H);
+        }
+    }
+    // enemies are solid, one dropped on the player or in a wall could
+    // leave it stuck
+    if(!clear) return false;
+    uint16_t i = enemies->count++;
+    ecs_position_set(&enemies->position[i], x, y);
+    // alternate the two looks
+    enemies->sprite[i] = (Sprite){ANIM_ENEMY, (x ^ y) & 1};
+    enemies->collider[i] = (Collider){ENEMY_W, ENEMY_H};
+    return true;
+}
+
+// take enemy i off the screen and queue it to come back later
+static void kill_enemy(World* const world, uint16_t i) {
+    EnemyTable* enemies = &world->enemies;
+    ECS_SWAP_REMOVE(enemies, position, i);
+    ECS_SWAP_REMOVE(enemies, sprite, i);
+    ECS_SWAP_REMOVE(enemies, collider, i);
+    enemies->count--;
+    RespawnTable* respawns = &world->respawns;
+    respawns->lifetime[respawns->count++] = (Lifetime){ENEMY_RESPAWN_STEPS};
+}
+
+// where the camera wants to be: the player in the middle of the screen,
+// but never showing past the edge of the map
+static void camera_target(const PluginState* const plugin_state, int16_t* const x, int16_t* const y) {
+    const Position* player = &plugin_state->world.player.position[0];
+    const Tilemap* map = plugin_state->map;
+    int16_t max_x = tilemap_width_px(map) - SCREEN_WIDTH;
+    int16_t max_y = tilemap_height_px(map) - SCREEN_HEIGHT;
+    *x = player->x + PLAYER_W / 2 - SCREEN_WIDTH / 2;
+    *y = player->y + PLAYER_H / 2 - SCREEN_HEIGHT / 2;
+    *x = *x < 0 ? 0 : *x > max_x ? max_x : *x;
+    *y = *y < 0 ? 0 : *y > max_y ? max_y : *y;
+}
+
+// move the camera to its target, and stream in the map around the new view
+static void camera_system(PluginState* const plugin_state) {
+    Position* camera = &plugin_state->camera;
+    camera->prev_x = camera->x;
+    camera->prev_y = camera->y;
+    camera_target(plugin_state, &camera->x, &camera->y);
+    // everything between where the camera was and is now, drawing
+    // interpolates between the two
+    int16_t x0 = camera->x < camera->prev_x ? camera->x : camera->prev_x;
+    int16_t y0 = camera->y < camera->prev_y ? camera->y : camera->prev_y;
+    tilemap_stream(plugin_state->map, x0 - TILE_W, y0 - TILE_H, VIEW_COLS * TILE_W + TILE_W, VIEW_ROWS * TILE_H + TILE_H);
+}
 
+// copy the tiles under the camera out for drawing
+static void view_system(PluginState* const plugin_state) {
+    const Position* camera = &plugin_state->camera;
+    TileView* view = &plugin_state->view;
+    int16_t x0 = camera->x < camera->prev_x ? camera->x : camera->prev_x;
+    int16_t y0 = camera->y < camera->prev_y ? camera->y : camera->prev_y;
+    view->tx = floor_div(x0, TILE_W);
+    view->ty = floor_div(y0, TILE_H);
+    for(uint8_t row = 0; row < VIEW_ROWS; row++) {
+        for(uint8_t col = 0; col < VIEW_COLS; col++) {
+            view->tiles[row][col] = tilemap_get(plugin_state->map, view->tx + col, view->ty + row);
+        }
+    }
+}
 
-    // projectile
-    draw_projectile(plugin_state, canvas);
+// copy out the frames of every sprite there is for drawing. runs after
+// every pass, input turns the player as well as logic steps do
+static void sprite_view_system(PluginState* const plugin_state) {
+    const World* world = &plugin_state->world;
+    SpriteView* view = &plugin_state->sprite_view;
+    ecs_view_begin(view);
+    ecs_view_sprites(view, plugin_state->sprites, walk_anims, world->enemies.sprite, world->enemies.count);
+    ecs_view_sprites(view, plugin_state->sprites, walk_anims, world->player.sprite, world->player.count);
 }
 
 // pass plugin state pointer to have its x,y set to default
 static void walk_state_init(PluginState* const plugin_state) {
+    // start from all empty tables, unused rows stay zero so snapshots of
+    // an unchanged world compare equal. nothing is left to whatever the
+    // heap had, replays and golden frames depend on it
+    memset(plugin_state, 0, sizeof(PluginState));
+    World* world = &plugin_state->world;
     // player walk stuff init
-    plugin_state->player.x = 30;
-    plugin_state->player.y = 30;
-    plugin_state->player.speed = 4;
-    plugin_state->player.dir = DOWN;
-    plugin_state->player.is_moving = false;
-    // player shoot stuff init
-    plugin_state->player.projectile.visible = false;
-    plugin_state->player.projectile.dir = plugin_state->player.dir;
-    plugin_state->player.projectile.speed = PROJECTILE_SPEED;
+    PlayerTable* player = &world->player;
+    player->count = 1;
+    ecs_position_set(&player->position[0], 30, 30);
+    player->velocity[0] = (Velocity){0, 0};
+    player->sprite[0] = (Sprite){ANIM_DOWN, 0};
+    player->collider[0] = (Collider){PLAYER_W, PLAYER_H};
+    player->control[0] = (PlayerControl){.speed = 4, .dir = DOWN, .is_moving = false};
+    // the map, and the bit of it around the player
+    plugin_state->map = tilemap_alloc(WALK_MAP_PATH);
+    plugin_state->sprites = asset_pack_alloc(WALK_SPRITES_PATH, SPRITE_W, SPRITE_H);
+    // the camera starts where it's going, so the first stream and view
+    // cover just the player's surroundings
+    int16_t cam_x, cam_y;
+    camera_target(plugin_state, &cam_x, &cam_y);
+    ecs_position_set(&plugin_state->camera, cam_x, cam_y);
+    camera_system(plugin_state);
+    view_system(plugin_state);
+    // enemies, placed after the player so they keep clear of it. any that
+    // don't fit yet wait in the respawn table
+    for(uint8_t i = 0; i < ENEMY_COUNT; i++) {
+        if(!spawn_enemy(world, &plugin_state->camera, plugin_state->map)) {
+            world->respawns.lifetime[world->respawns.count++] = (Lifetime){0};
+        }
+    }
+    sprite_view_system(plugin_state);
+}
 
+static void walk_state_free(PluginState* const plugin_state) {
+    tilemap_free(plugin_state->map);
+    asset_pack_free(plugin_state->sprites);
 }
 
+// player: walk where the keys say, cycling the walk frames
+static void player_system(PlayerTable* const player) {
+    const PlayerControl* control = &player->control[0];
+    Sprite* sprite = &player->sprite[0];
+    if(control->is_moving) {
+        // iterate frame, 0 is standing still so skip it
+        sprite->frame = (sprite->frame + 1) % walk_anims[sprite->anim].frame_count;
+        if(!sprite->frame) sprite->frame++;
+        player->velocity[0] = (Velocity){dir_dx[control->dir] * control->speed, dir_dy[control->dir] * control->speed};
+    } else {
+        sprite->frame = 0;
+        player->velocity[0] = (Velocity){0, 0};
+    }
+}
 
-static void process_step(PluginState* const plugin_state, NotificationApp* notify) {
-    UNUSED(notify);
-
-    // player move logic
-    if(plugin_state->player.is_moving) {
-        // iterate frame
-        plugin_state->player.frame = (plugin_state->player.frame + 1) % 3;
-        if(!plugin_state->player.frame) plugin_state->player.frame++;
-
-
-        uint8_t d = plugin_state->player.dir;
-        switch(d) {
-            case UP:
-                plugin_state->player.y -= plugin_state->player.speed;
-                break;
-            case DOWN:
-                plugin_state->player.y += plugin_state->player.speed;
-                break;
-            case LEFT:
-                plugin_state->player.x -= plugin_state->player.speed;
-                break;
-            case RIGHT:
-                plugin_state->player.x += plugin_state->player.speed;
-                break;
+// enemies and walls are solid, walking into one just doesn't happen
+static void player_block_system(
+    PlayerTable* const player,
+    const EnemyTable* const enemies,
+    const SpatialGrid* const grid,
+    const Tilemap* const map) {
+    Position* position = &player->position[0];
+    if(position->x == position->prev_x && position->y == position->prev_y) return;
+    const Collider* collider = &player->collider[0];
+    if(tiles_in_box(
+           map, tile_blocks_walking, position->x + PLAYER_FEET_X, position->y + PLAYER_FEET_Y, PLAYER_FEET_W,
+           PLAYER_FEET_H) ||
+       enemy_at(grid, enemies, 0, sprite_mask(&player->sprite[0]), position->x, position->y, collider->w, collider->h) >= 0) {
+        position->x = position->prev_x;
+        position->y = position->prev_y;
+    }
+}
+
+// projectiles go away when they get old, leave the screen or hit a wall
+static void projectile_expire_system(World* const world, const Position* const camera, const Tilemap* const map) {
+    ProjectileTable* projectiles = &world->projectiles;
+    ecs_age(projectiles->lifetime, projectiles->count);
+    // backwards, so the row swapped into a hole was already looked at
+    for(uint16_t i = projectiles->count; i--;) {
+        const Position* position = &projectiles->position[i];
+        const Collider* collider = &projectiles->collider[i];
+        bool off_screen = position->x + collider->w <= camera->x || position->x >= camera->x + SCREEN_WIDTH ||
+                          position->y + collider->h <= camera->y || position->y >= camera->y + SCREEN_HEIGHT;
+        if(!projectiles->lifetime[i].steps || off_screen ||
+           tiles_in_box(map, tile_blocks_shots, position->x, position->y, collider->w, collider->h)) {
+            despawn_projectile(world, i);
         }
-    } else {
-        plugin_state->player.frame = 0;
     }
+}
 
-    // player projectile logic
-    if(plugin_state->player.projectile.visible) {
-        uint8_t d = plugin_state->player.projectile.dir;
-        switch(d) {
-            case UP:
-                plugin_state->player.projectile.y -= plugin_state->player.projectile.speed;
-                break;
-            case DOWN:
-                plugin_state->player.projectile.y += plugin_state->player.projectile.speed;
-                break;
-            case LEFT:
-                plugin_state->player.projectile.x -= plugin_state->player.projectile.speed;
-                break;
-            case RIGHT:
-                plugin_state->player.projectile.x += plugin_state->player.projectile.speed;
-                break;
+// shoot whatever the projectiles ran into. each projectile only looks at the
+// grid cells around it, not at every enemy.
+static void projectile_hit_system(PluginState* const plugin_state, const SpatialGrid* const grid, NotificationApp* notify) {
+    World* world = &plugin_state->world;
+    ProjectileTable* projectiles = &world->projectiles;
+    // the grid holds enemy rows as of the start of the step, so enemies are
+    // only marked here and removed once every projectile has been checked
+    uint32_t shot = 0;
+    for(uint16_t i = projectiles->count; i--;) {
+        const Position* position = &projectiles->position[i];
+        const Collider* collider = &projectiles->collider[i];
+        int8_t hit = enemy_at(grid, &world->enemies, shot, projectile_mask, position->x, position->y, collider->w, collider->h);
+        if(hit < 0) continue;
+        despawn_projectile(world, i);
+        shot |= 1u << hit;
+        plugin_state->kills++;
+        notification_message(notify, &sequence_blip);
+    }
+    // highest row first, so swapping in the last row never moves one still
+    // to be removed
+    while(shot) {
+        uint8_t i = 31 - __builtin_clz(shot);
+        kill_enemy(world, i);
+        shot &= ~(1u << i);
+    }
+}
+
+// bring back the ones shot a while ago, somewhere on screen. one with
+// nowhere to go stays in the table at zero and tries again next step
+static void respawn_system(World* const world, const Position* const camera, const Tilemap* const map) {
+    RespawnTable* respawns = &world->respawns;
+    if(!ecs_age(respawns->lifetime, respawns->count)) return;
+    for(uint16_t i = respawns->count; i--;) {
+        if(!respawns->lifetime[i].steps && spawn_enemy(world, camera, map)) {
+            ECS_SWAP_REMOVE(respawns, lifetime, i);
+            respawns->count--;
         }
     }
+}
 
-}
\ No newline at end of file
+static void process_step(PluginState* const plugin_state, NotificationApp* notify) {
+    World* world = &plugin_state->world;
+
+    // where the enemies are this step, for all the collision checks below
+    SpatialGrid grid;
+    spatial_grid_build(
+        &grid, plugin_state->camera.x, plugin_state->camera.y, world->enemies.position, world->enemies.count, ENEMY_W, ENEMY_H);
+
+    player_system(&world->player);
+    ecs_motion(world->player.position, world->player.velocity, world->player.count);
+    ecs_motion(world->projectiles.position, world->projectiles.velocity, world->projectiles.count);
+    player_block_system(&world->player, &world->enemies, &grid, plugin_state->map);
+    camera_system(plugin_state);
+    projectile_expire_system(world, &plugin_state->camera, plugin_state->map);
+    projectile_hit_system(plugin_state, &grid, notify);
+    respawn_system(world, &plugin_state->camera, plugin_state->map);
+    view_system(plugin_state);
+}
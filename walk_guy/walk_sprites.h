@@ -1,229 +1,298 @@
 #pragma once
 
-uint8_t down_array[3][16][16] = {
+#include <stdint.h>
+
+// generated by tools/sprite_compiler.py from walk_guy.json, do not edit by hand.
+//
+// 16x16 sprites, 1 bit per pixel, packed xbm style:
+// 2 bytes per row, low byte first, lsb is the leftmost pixel.
+// the frames themselves are in walk_guy.pack, see common/asset_pack.h.
+// <PREFIX>_ASSET_<NAME> is the asset's index in there.
+
+#define SPRITE_W 16
+#define SPRITE_H 16
+#define SPRITE_ROW_BYTES (SPRITE_W / 8)
+#define SPRITE_FRAME_BYTES (SPRITE_ROW_BYTES * SPRITE_H)
+
+#define SPRITE_ASSET_DOWN 0
+#define SPRITE_ASSET_DOWN_FRAMES 3
+#define SPRITE_ASSET_DOWN_MIRROR 0
+#define SPRITE_ASSET_UP 1
+#define SPRITE_ASSET_UP_FRAMES 3
+#define SPRITE_ASSET_UP_MIRROR 0
+#define SPRITE_ASSET_LEFT 2
+#define SPRITE_ASSET_LEFT_FRAMES 3
+#define SPRITE_ASSET_LEFT_MIRROR 0
+#define SPRITE_ASSET_RIGHT SPRITE_ASSET_LEFT
+#define SPRITE_ASSET_RIGHT_FRAMES 3
+#define SPRITE_ASSET_RIGHT_MIRROR 1
+#define SPRITE_ASSET_ENEMY 3
+#define SPRITE_ASSET_ENEMY_FRAMES 2
+#define SPRITE_ASSET_ENEMY_MIRROR 0
+
+static const uint16_t down_mask[3][SPRITE_H] = {
     {
-        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 1, 0, 0, 1, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 1, 1, 1, 1, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0},
-        {0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0},
-        {0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0},
-        {0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0},
-        {0, 1, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 1, 0},
-        {0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 1, 0, 0, 1, 1, 1, 0, 0, 0, 0},
+        0x0000, // ................
+        0x03c0, // ......####......
+        0x07e0, // .....######.....
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x07e0, // .....######.....
+        0x0ff0, // ....########....
+        0x1ff8, // ...##########...
+        0x3ffc, // ..############..
+        0x7ffe, // .##############.
+        0x7ffe, // .##############.
+        0x7ffe, // .##############.
+        0x3ffc, // ..############..
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
     },
     {
-        {0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 1, 0, 0, 1, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 1, 1, 1, 1, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0},
-        {0, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0},
-        {0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0},
-        {0, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0},
-        {0, 0, 1, 0, 0, 1, 1, 1, 1, 1, 1, 1, 0, 1, 0, 0},
-        {0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0},
+        0x03c0, // ......####......
+        0x07e0, // .....######.....
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x07e0, // .....######.....
+        0x0ff0, // ....########....
+        0x1ff8, // ...##########...
+        0x3ffc, // ..############..
+        0x3ffc, // ..############..
+        0x3ffc, // ..############..
+        0x3ffc, // ..############..
+        0x1ff8, // ...##########...
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x0f00, // ........####....
     },
     {
-        {0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 1, 0, 0, 1, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 1, 1, 1, 1, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0},
-        {0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0},
-        {0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0},
-        {0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0},
-        {0, 0, 1, 0, 1, 1, 1, 1, 1, 1, 1, 0, 0, 1, 0, 0},
-        {0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 1, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0},
+        0x03c0, // ......####......
+        0x07e0, // .....######.....
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x07e0, // .....######.....
+        0x0ff0, // ....########....
+        0x1ff8, // ...##########...
+        0x3ffc, // ..############..
+        0x3ffc, // ..############..
+        0x3ffc, // ..############..
+        0x3ffc, // ..############..
+        0x1ff8, // ...##########...
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x00f0, // ....####........
     },
 };
 
-uint8_t up_array[3][16][16] = {
+static const uint16_t up_mask[3][SPRITE_H] = {
     {
-        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0},
-        {0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0},
-        {0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0},
-        {0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0},
-        {0, 1, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 1, 0},
-        {0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 1, 0, 0, 1, 1, 1, 0, 0, 0, 0},
+        0x0000, // ................
+        0x03c0, // ......####......
+        0x07e0, // .....######.....
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x07e0, // .....######.....
+        0x0ff0, // ....########....
+        0x1ff8, // ...##########...
+        0x3ffc, // ..############..
+        0x7ffe, // .##############.
+        0x7ffe, // .##############.
+        0x7ffe, // .##############.
+        0x3ffc, // ..############..
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
     },
     {
-        {0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 1, 1, 1, 1, 0, 0, 1, 0, 0, 0},
-        {0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0},
-        {0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0},
-        {0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0},
-        {0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0},
-        {0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0},
+        0x03c0, // ......####......
+        0x07e0, // .....######.....
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x0fe0, // .....#######....
+        0x1ff0, // ....#########...
+        0x3ff8, // ...###########..
+        0x3ffc, // ..############..
+        0x3ffc, // ..############..
+        0x1ffc, // ..###########...
+        0x0ff8, // ...#########....
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x0f00, // ........####....
     },
     {
-        {0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 1, 0, 0, 1, 1, 1, 1, 0, 1, 0, 0, 0, 0},
-        {0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0},
-        {0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0},
-        {0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0},
-        {0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0},
-        {0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 1, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0},
+        0x03c0, // ......####......
+        0x07e0, // .....######.....
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x07f0, // ....#######.....
+        0x0ff8, // ...#########....
+        0x1ffc, // ..###########...
+        0x3ffc, // ..############..
+        0x3ffc, // ..############..
+        0x3ff8, // ...###########..
+        0x1ff0, // ....#########...
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x0ff0, // ....########....
+        0x00f0, // ....####........
     },
 };
 
-uint8_t left_array[3][16][16] = {
+static const uint16_t left_mask[3][SPRITE_H] = {
     {
-        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 1, 1, 0, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0},
+        0x0000, // ................
+        0x00e0, // .....###........
+        0x01f0, // ....#####.......
+        0x03f0, // ....######......
+        0x03f0, // ....######......
+        0x01f0, // ....#####.......
+        0x03e0, // .....#####......
+        0x07f0, // ....#######.....
+        0x07f0, // ....#######.....
+        0x07f0, // ....#######.....
+        0x07f0, // ....#######.....
+        0x07f0, // ....#######.....
+        0x07f0, // ....#######.....
+        0x03f0, // ....######......
+        0x03f0, // ....######......
+        0x03f0, // ....######......
     },
     {
-        {0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-        {0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0},
-        {0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 1, 0, 1, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 1, 0, 1, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0},
-        {0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
+        0x01c0, // ......###.......
+        0x03e0, // .....#####......
+        0x07e0, // .....######.....
+        0x07e0, // .....######.....
+        0x03e0, // .....#####......
+        0x03c0, // ......####......
+        0x0780, // .......####.....
+        0x0fc0, // ......######....
+        0x1ff8, // ...##########...
+        0x1ff8, // ...##########...
+        0x0ff0, // ....########....
+        0x07e0, // .....######.....
+        0x07f0, // ....#######.....
+        0x0ff8, // ...#########....
+        0x1ff8, // ...##########...
+        0x0ff8, // ...#########....
     },
     {
-        {0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 1, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0},
-        {0, 1, 1, 1, 0, 1, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0},
-        {0, 1, 0, 1, 0, 1, 0, 0, 0, 0, 1, 0, 1, 0, 1, 0},
-        {0, 1, 1, 1, 1, 1, 0, 1, 1, 1, 1, 1, 0, 0, 1, 0},
-        {0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 1, 0, 1, 1, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 1, 0, 1, 0, 0, 1, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 0},
+        0x01c0, // ......###.......
+        0x03e0, // .....#####......
+        0x07e0, // .....######.....
+        0x07e0, // .....######.....
+        0x03e0, // .....#####......
+        0x0fe0, // .....#######....
+        0x1ff0, // ....#########...
+        0x3ffe, // .#############..
+        0x7ffe, // .##############.
+        0x7ffe, // .##############.
+        0x3fe0, // .....#########..
+        0x07e0, // .....######.....
+        0x07e0, // .....######.....
+        0x1fe0, // .....########...
+        0x1fe0, // .....########...
+        0x0fe0, // .....#######....
     },
 };
 
-uint8_t right_array[3][16][16] = {
+static const uint16_t right_mask[3][SPRITE_H] = {
     {
-        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0},
+        0x0000, // ................
+        0x0700, // ........###.....
+        0x0f80, // .......#####....
+        0x0fc0, // ......######....
+        0x0fc0, // ......######....
+        0x0f80, // .......#####....
+        0x07c0, // ......#####.....
+        0x0fe0, // .....#######....
+        0x0fe0, // .....#######....
+        0x0fe0, // .....#######....
+        0x0fe0, // .....#######....
+        0x0fe0, // .....#######....
+        0x0fe0, // .....#######....
+        0x0fc0, // ......######....
+        0x0fc0, // ......######....
+        0x0fc0, // ......######....
     },
     {
-        {0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0},
-        {0, 0, 0, 1, 0, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 1, 0, 0, 0},
-        {0, 0, 0, 1, 0, 0, 1, 0, 0, 0, 1, 0, 1, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0},
+        0x0380, // .......###......
+        0x07c0, // ......#####.....
+        0x07e0, // .....######.....
+        0x07e0, // .....######.....
+        0x07c0, // ......#####.....
+        0x03c0, // ......####......
+        0x01e0, // .....####.......
+        0x03f0, // ....######......
+        0x1ff8, // ...##########...
+        0x1ff8, // ...##########...
+        0x0ff0, // ....########....
+        0x07e0, // .....######.....
+        0x0fe0, // .....#######....
+        0x1ff0, // ....#########...
+        0x1ff8, // ...##########...
+        0x1ff0, // ....#########...
     },
     {
-        {0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-        {0, 0, 1, 0, 0, 1, 0, 0, 0, 0, 1, 0, 1, 1, 1, 0},
-        {0, 1, 0, 1, 0, 1, 0, 0, 0, 0, 1, 0, 1, 0, 1, 0},
-        {0, 1, 0, 0, 1, 1, 1, 1, 1, 0, 1, 1, 1, 1, 1, 0},
-        {0, 0, 1, 1, 0, 1, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 1, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 1, 1, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0},
+        0x0380, // .......###......
+        0x07c0, // ......#####.....
+        0x07e0, // .....######.....
+        0x07e0, // .....######.....
+        0x07c0, // ......#####.....
+        0x07f0, // ....#######.....
+        0x0ff8, // ...#########....
+        0x7ffc, // ..#############.
+        0x7ffe, // .##############.
+        0x7ffe, // .##############.
+        0x07fc, // ..#########.....
+        0x07e0, // .....######.....
+        0x07e0, // .....######.....
+        0x07f8, // ...########.....
+        0x07f8, // ...########.....
+        0x07f0, // ....#######.....
     },
-};
\ No newline at end of file
+};
+
+static const uint16_t enemy_mask[2][SPRITE_H] = {
+    {
+        0x0000, // ................
+        0x0000, // ................
+        0x0000, // ................
+        0x0000, // ................
+        0x03c0, // ......####......
+        0x0ff0, // ....########....
+        0x1ff8, // ...##########...
+        0x3ffc, // ..############..
+        0x3ffc, // ..############..
+        0x7ffe, // .##############.
+        0x7ffe, // .##############.
+        0x7ffe, // .##############.
+        0x7ffe, // .##############.
+        0x3ffc, // ..############..
+        0x1ff8, // ...##########...
+        0x0000, // ................
+    },
+    {
+        0x0000, // ................
+        0x0000, // ................
+        0x0000, // ................
+        0x0000, // ................
+        0x0000, // ................
+        0x07e0, // .....######.....
+        0x1ff8, // ...##########...
+        0x3ffc, // ..############..
+        0x7ffe, // .##############.
+        0x7ffe, // .##############.
+        0xffff, // ################
+        0xffff, // ################
+        0xffff, // ################
+        0x7ffe, // .##############.
+        0x3ffc, // ..############..
+        0x0000, // ................
+    },
+};